@@ -35,8 +35,10 @@ THE SOFTWARE.
 
 #include "flusspferd/arguments.hpp"
 #include "flusspferd/array.hpp"
+#include "flusspferd/array_builder.hpp"
 #include "flusspferd/binary.hpp"
 #include "flusspferd/call_context.hpp"
+#include "flusspferd/callable.hpp"
 #include "flusspferd/class.hpp"
 #include "flusspferd/class_description.hpp"
 #include "flusspferd/context.hpp"
@@ -48,7 +50,11 @@ THE SOFTWARE.
 #include "flusspferd/exception.hpp"
 #include "flusspferd/function_adapter.hpp"
 #include "flusspferd/function.hpp"
+#include "flusspferd/gc_allocator.hpp"
+#include "flusspferd/gc_scheduler.hpp"
+#include "flusspferd/gc_stats.hpp"
 #include "flusspferd/getopt.hpp"
+#include "flusspferd/heap_census.hpp"
 #include "flusspferd/modules.hpp"
 #include "flusspferd/init.hpp"
 #include "flusspferd/load_core.hpp"
@@ -57,13 +63,16 @@ THE SOFTWARE.
 #include "flusspferd/native_function.hpp"
 #include "flusspferd/native_object_base.hpp"
 #include "flusspferd/object.hpp"
+#include "flusspferd/object_pool.hpp"
 #include "flusspferd/properties_functions.hpp"
 #include "flusspferd/property_attributes.hpp"
 #include "flusspferd/property_iterator.hpp"
+#include "flusspferd/property_key.hpp"
 #include "flusspferd/root.hpp"
 #include "flusspferd/security.hpp"
 #include "flusspferd/string.hpp"
 #include "flusspferd/string_io.hpp"
+#include "flusspferd/struct_description.hpp"
 #include "flusspferd/system.hpp"
 #include "flusspferd/tracer.hpp"
 #include "flusspferd/value.hpp"
@@ -28,9 +28,8 @@ THE SOFTWARE.
 #define FLUSSPFERD_ARGUMENTS_HPP
 
 #include "spidermonkey/arguments.hpp"
-#include "root.hpp"
+#include "spidermonkey/root.hpp"
 #include "value.hpp"
-#include <boost/shared_ptr.hpp>
 #include <vector>
 
 namespace flusspferd {
@@ -40,10 +39,12 @@ namespace flusspferd {
  *
  * @ingroup functions
  */
-class arguments : public Impl::arguments_impl {
-private:
-  std::vector<boost::shared_ptr<root_value> > roots;
-
+class arguments
+  : public Impl::arguments_impl
+#ifndef IN_DOXYGEN
+  , private Impl::extra_roots
+#endif
+{
 public:
   /// An empty arguments object.
   arguments() { }
@@ -54,6 +55,12 @@ public:
   { }
 #endif
 
+  /// Copy constructor. Rooted arguments stay rooted in the copy.
+  arguments(arguments const &o);
+
+  /// Assignment operator. Rooted arguments stay rooted in the copy.
+  arguments &operator=(arguments const &o);
+
   /**
    * An arguments object filled with the elements of a vector.
    *
@@ -94,12 +101,21 @@ public:
   /**
    * Add a value to the back of the arguments list, rooting it.
    *
-   * The value will be explicitly rooted.
+   * The value will be explicitly rooted. All values of an arguments object
+   * share a single root registration, so rooting is cheap.
    *
    * @param v The element to be added.
    */
   void push_root(value const &v);
 
+  /**
+   * Remove all arguments, keeping the allocated buffer and the root.
+   *
+   * Only allowed on user-provided arguments. Useful to reuse one arguments
+   * object for many calls.
+   */
+  void clear();
+
   /**
    * Access the first argument.
    *
@@ -159,6 +175,11 @@ public:
 
   /// Return an iterator to the end of the arguments list.
   iterator end();
+
+private:
+#ifndef IN_DOXYGEN
+  void trace(tracer &trc);
+#endif
 };
 
 /**
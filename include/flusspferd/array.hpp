@@ -28,7 +28,9 @@ THE SOFTWARE.
 #define FLUSSPFERD_ARRAY_HPP
 
 #include "object.hpp"
+#include "spidermonkey/root.hpp"
 #include <boost/utility/in_place_factory.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 #include <cassert>
 
@@ -63,6 +65,7 @@ public:
   /// Get an array element.
   value get_element(std::size_t n) const;
 
+  /// Append an element.
   void push(value val);
 
   /// Set an array element.
@@ -0,0 +1,111 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef FLUSSPFERD_ARRAY_BUILDER_HPP
+#define FLUSSPFERD_ARRAY_BUILDER_HPP
+
+#include "spidermonkey/value.hpp"
+#include "spidermonkey/root.hpp"
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+namespace flusspferd {
+
+class value;
+class array;
+class tracer;
+
+/**
+ * Builds a new Javascript Array from C++.
+ *
+ * The elements are collected in a rooted C++ buffer and the Array is created
+ * in one step by #finish, instead of growing it one <code>push</code> at a
+ * time.
+ *
+ * @code
+array_builder builder(names.size());
+for (std::size_t i = 0; i < names.size(); ++i)
+  builder.push(value(names[i]));
+array result = builder.finish();
+@endcode
+ *
+ * An array_builder must be used and destroyed on the thread that created it.
+ *
+ * @ingroup value_types
+ */
+class array_builder
+  : private boost::noncopyable
+#ifndef IN_DOXYGEN
+  , private Impl::extra_roots
+#endif
+{
+public:
+  /**
+   * Constructor.
+   *
+   * @param capacity The number of elements to reserve space for.
+   */
+  explicit array_builder(std::size_t capacity = 0);
+
+  /// Destructor.
+  ~array_builder();
+
+  /// Reserve space for @p n elements.
+  void reserve(std::size_t n);
+
+  /**
+   * Append an element. The element is rooted until #finish is called.
+   *
+   * @param v The element.
+   */
+  void push(value const &v);
+
+  /// The number of elements collected so far.
+  std::size_t size() const;
+
+  /// Whether no elements have been collected.
+  bool empty() const { return size() == 0; }
+
+  /**
+   * Create the Array from the collected elements.
+   *
+   * The builder is empty afterwards and can be reused.
+   *
+   * @return The new Array.
+   */
+  array finish();
+
+private:
+#ifndef IN_DOXYGEN
+  void trace(tracer &trc);
+
+  std::vector<jsval> elements;
+#endif
+};
+
+}
+
+#endif
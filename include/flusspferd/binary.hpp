@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "native_object_base.hpp"
 #include "class_description.hpp"
+#include "gc_allocator.hpp"
 #include <vector>
 
 namespace flusspferd {
@@ -65,6 +66,7 @@ protected:
   binary(object const &o, call_context &x);
   binary(object const &o, binary const &b);
   binary(object const &o, element_type const *p, std::size_t n);
+  binary(object const &o, vector_type &&data);
 
   virtual binary &create(element_type const *p, std::size_t n) = 0;
   virtual value element(element_type byte) = 0;
@@ -86,6 +88,19 @@ public:
 
   vector_type const &get_const_data() { return get_data(); }
 
+  std::size_t external_size() const;
+
+  /**
+   * Report the size of the buffer to the garbage collector.
+   *
+   * The buffer is a plain vector (so that one can be adopted from the
+   * caller) and not allocated through gc_allocator. Call this after changing
+   * the buffer through #get_data.
+   */
+  void update_external_size() {
+    v_size.update(v_data.capacity());
+  }
+
 protected:
   void do_append(arguments &x);
 
@@ -113,11 +128,13 @@ public:
 
 private:
   vector_type v_data;
+  gc_external_size v_size;
 };
 
 FLUSSPFERD_CLASS_DESCRIPTION(
   byte_string,
   (full_name, "binary.ByteString")
+  (pooled, true)
   (constructor_name, "ByteString")
   (constructor_arity, 2)
   (base, binary)
@@ -138,6 +155,16 @@ public:
   byte_string(object const &o, binary const &b);
   byte_string(object const &o, element_type const *p, std::size_t n);
 
+  /**
+   * Adopt @p data without copying it.
+   *
+   * @code
+binary::vector_type data = load_blob();
+byte_string &s = create_native_object<byte_string>(object(), std::move(data));
+   * @endcode
+   */
+  byte_string(object const &o, vector_type &&data);
+
   virtual binary &create(element_type const *p, std::size_t n);
   virtual value element(element_type byte);
 
@@ -154,6 +181,7 @@ public:
 FLUSSPFERD_CLASS_DESCRIPTION(
   byte_array,
   (full_name, "binary.ByteArray")
+  (pooled, true)
   (constructor_name, "ByteArray")
   (constructor_arity, 2)
   (base, binary)
@@ -189,6 +217,16 @@ public:
   byte_array(object const &o, binary const &b);
   byte_array(object const &o, element_type const *p, std::size_t n);
 
+  /**
+   * Adopt @p data without copying it.
+   *
+   * @code
+binary::vector_type data = load_blob();
+byte_array &a = create_native_object<byte_array>(object(), std::move(data));
+   * @endcode
+   */
+  byte_array(object const &o, vector_type &&data);
+
   virtual binary &create(element_type const *p, std::size_t n);
   virtual value element(element_type byte);
 
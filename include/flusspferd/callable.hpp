@@ -0,0 +1,349 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_CALLABLE_HPP
+#define FLUSSPFERD_CALLABLE_HPP
+
+#include "spidermonkey/root.hpp"
+#include "object.hpp"
+#include "arguments.hpp"
+#include "value.hpp"
+#include "convert.hpp"
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace flusspferd {
+
+/**
+ * The results of a batch of calls made through callable::call_each.
+ *
+ * For every call, either its return value or the exception it threw is
+ * recorded. All recorded values stay rooted as long as the object lives or
+ * until it is cleared.
+ *
+ * Must be used and destroyed on the thread that created it.
+ *
+ * @ingroup functions
+ */
+class call_results
+  : private boost::noncopyable
+#ifndef IN_DOXYGEN
+  , private Impl::extra_roots
+#endif
+{
+public:
+  /// Construct an empty result set.
+  call_results();
+
+  /// Destructor.
+  ~call_results();
+
+  /// The number of recorded calls.
+  std::size_t size() const { return entries.size(); }
+
+  /// Whether no call has been recorded.
+  bool empty() const { return entries.empty(); }
+
+  /// The number of calls that threw an exception.
+  std::size_t failures() const { return n_failures; }
+
+  /**
+   * Whether call @p i returned normally.
+   *
+   * @param i The index of the call.
+   */
+  bool ok(std::size_t i) const { return entries[i].ok; }
+
+  /**
+   * The return value of call @p i, or @c undefined if it failed.
+   *
+   * @param i The index of the call.
+   */
+  value result(std::size_t i) const;
+
+  /**
+   * The exception thrown by call @p i, or @c undefined if it succeeded.
+   *
+   * @param i The index of the call.
+   */
+  value error(std::size_t i) const;
+
+  /// Reserve space for @p n results.
+  void reserve(std::size_t n) { entries.reserve(n); }
+
+  /// Forget all results.
+  void clear();
+
+#ifndef IN_DOXYGEN
+  void add(value const &v, bool ok);
+
+private:
+  void trace(tracer &trc);
+
+  struct entry {
+    value v;
+    bool ok;
+  };
+
+  std::vector<entry> entries;
+  std::size_t n_failures;
+#endif
+};
+
+/**
+ * A pre-resolved handle for a Javascript %function that is called often.
+ *
+ * object::call(char const*, ...) looks the method up by name on every call.
+ * A callable resolves the %function once, keeps it and the @c this object
+ * rooted for as long as the handle lives, and afterwards every call is a
+ * single JS_CallFunctionValue.
+ *
+ * A callable that was bound to a method name resolves the name lazily on the
+ * first call. If the property might have been replaced since, call
+ * invalidate() and the name will be looked up again on the next call.
+ *
+ * @code
+callable on_tick(hooks, "onTick");
+for (;;)
+  on_tick(now);
+@endcode
+ *
+ * A callable must be used and destroyed on the thread that created it.
+ *
+ * @ingroup functions
+ */
+class callable
+  : private boost::noncopyable
+#ifndef IN_DOXYGEN
+  , private Impl::extra_roots
+#endif
+{
+public:
+  /// Construct an empty handle.
+  callable();
+
+  /**
+   * Construct a handle for the method @p name of @p self.
+   *
+   * The method is resolved on the first call.
+   *
+   * @param self The object to look the method up on and call it on.
+   * @param name The method name.
+   */
+  callable(object const &self, std::string const &name);
+
+  /**
+   * Construct a handle for the %function @p fn, called on @p self.
+   *
+   * @param self The object to use as @c this.
+   * @param fn The %function.
+   */
+  callable(object const &self, object const &fn);
+
+  /// Destructor.
+  ~callable();
+
+  /**
+   * Rebind the handle to the method @p name of @p self.
+   *
+   * @param self The object to look the method up on and call it on.
+   * @param name The method name.
+   */
+  void reset(object const &self, std::string const &name);
+
+  /**
+   * Rebind the handle to the %function @p fn, called on @p self.
+   *
+   * @param self The object to use as @c this.
+   * @param fn The %function.
+   */
+  void reset(object const &self, object const &fn);
+
+  /// Unbind the handle completely.
+  void reset();
+
+  /**
+   * Drop the resolved %function.
+   *
+   * The next call looks the method up by name again. Handles that were bound
+   * to a %function instead of a name can not be resolved again and become
+   * empty.
+   */
+  void invalidate();
+
+  /**
+   * Resolve the method now, unless it is resolved already.
+   *
+   * @throw exception If the property is not a %function.
+   */
+  void resolve();
+
+  /// Whether the %function is resolved.
+  bool is_resolved() const;
+
+  /// Whether the handle is bound to anything.
+  bool empty() const;
+
+  /// The object the %function is called on.
+  object self() const;
+
+  /**
+   * The resolved %function.
+   *
+   * @return The %function, or @c undefined if it is not resolved.
+   */
+  value get_function() const;
+
+  /**
+   * Call the %function.
+   *
+   * The method is resolved first if necessary.
+   *
+   * @param arg The %function %arguments.
+   * @return The %function's return value.
+   */
+  value call(arguments const &arg = arguments());
+
+  /**
+   * Call the %function.
+   *
+   * @param arg The %function %arguments.
+   * @return The %function's return value.
+   */
+  value operator()(arguments const &arg = arguments()) {
+    return call(arg);
+  }
+
+  /**
+   * Call the %function once for every element of a range.
+   *
+   * The %function is resolved once, and a single %arguments buffer is
+   * filled by @p marshal for every element and reused for all calls. The
+   * results are appended to @p results. A call that throws a Javascript
+   * exception does not end the batch unless @p stop_on_error is set; the
+   * exception is recorded in @p results instead and cleared.
+   *
+   * @code
+on_tick.call_each(mobs.begin(), mobs.end(),
+  [](mob *m, arguments &arg) { arg.push_root(value(m->id())); },
+  results);
+@endcode
+   *
+   * @param first The beginning of the range.
+   * @param last The end of the range.
+   * @param marshal A functor called as <code>marshal(*it, arg)</code> that
+   *                pushes the %arguments for one element onto @c arg.
+   * @param results Receives one result per call.
+   * @param stop_on_error Whether to stop at the first failed call.
+   * @return The number of calls made.
+   */
+  template<typename InputIterator, typename Marshaller>
+  std::size_t call_each(
+    InputIterator first, InputIterator last, Marshaller marshal,
+    call_results &results, bool stop_on_error = false)
+  {
+    resolve();
+    arguments arg;
+    std::size_t n = 0;
+    for (; first != last; ++first) {
+      arg.clear();
+      marshal(*first, arg);
+      ++n;
+      if (!call_one(arg, results) && stop_on_error)
+        break;
+    }
+    return n;
+  }
+
+  /**
+   * Call the %function once for every tuple in a range.
+   *
+   * Each element is a <code>std::tuple</code> whose members are converted to
+   * the %arguments of one call.
+   *
+   * @see call_each(InputIterator, InputIterator, Marshaller, call_results&, bool)
+   *
+   * @param tuples The range of argument tuples.
+   * @param results Receives one result per call.
+   * @param stop_on_error Whether to stop at the first failed call.
+   * @return The number of calls made.
+   */
+  template<typename Range>
+  std::size_t call_each(
+    Range const &tuples, call_results &results, bool stop_on_error = false)
+  {
+    return call_each(
+      tuples.begin(), tuples.end(), tuple_marshaller(), results,
+      stop_on_error);
+  }
+
+#ifndef IN_DOXYGEN
+  template<typename T0, typename... T>
+  value operator()(T0 const &param0, T const &...params) {
+    arguments arg;
+    push_call_arguments(arg, param0, params...);
+    return call(arg);
+  }
+
+private:
+  template<typename... T>
+  static void push_call_arguments(arguments &arg, T const &...params) {
+    (arg.push_root(typename convert<T const &>::to_value().perform(params)),
+     ...);
+  }
+
+  struct tuple_marshaller {
+    template<typename... T>
+    void operator()(std::tuple<T...> const &params, arguments &arg) const {
+      std::apply(
+        [&arg](T const &...p) { push_call_arguments(arg, p...); }, params);
+    }
+  };
+
+  bool call_one(arguments const &arg, call_results &results);
+
+  void trace(tracer &trc);
+
+  object this_;
+  value fn;
+  std::string name;
+#else
+  /**
+   * Call the %function.
+   *
+   * @param ... The %function %arguments.
+   * @return The %function's return value.
+   */
+  value operator()(...);
+#endif
+};
+
+}
+
+#endif
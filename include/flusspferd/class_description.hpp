@@ -29,8 +29,12 @@ THE SOFTWARE.
 
 #ifndef PREPROC_DEBUG
 #include <memory>
+#include <utility>
 #include "class.hpp"
 #include "native_object_base.hpp"
+#include "function_adapter.hpp"
+#include "spidermonkey/function_spec.hpp"
+#include "object_pool.hpp"
 #endif
 #include "detail/limit.hpp"
 #include <boost/preprocessor.hpp>
@@ -81,7 +85,7 @@ THE SOFTWARE.
   /* */
 
 #define FLUSSPFERD_CD_PARAM_INITIAL \
-  (13, ( \
+  (15, ( \
     ~cpp_name~,                        /* name */ \
     ::flusspferd::native_object_base,  /* base class */ \
     ~constructor_name~,                /* constructor name */ \
@@ -94,7 +98,9 @@ THE SOFTWARE.
     (~, none, ~),                      /* constructor properties */ \
     false,                             /* custom enumerate */ \
     0,                                 /* augment constructor (custom func.)*/\
-    0                                  /* augment prototype (custom func.) */ \
+    0,                                 /* augment prototype (custom func.) */ \
+    false,                             /* deferred finalize */ \
+    false                              /* pooled */ \
   )) \
   /* */
 
@@ -111,6 +117,8 @@ THE SOFTWARE.
 #define FLUSSPFERD_CD_PARAM__custom_enumerate        10
 #define FLUSSPFERD_CD_PARAM__augment_constructor     11
 #define FLUSSPFERD_CD_PARAM__augment_prototype       12
+#define FLUSSPFERD_CD_PARAM__deferred_finalize       13
+#define FLUSSPFERD_CD_PARAM__pooled                  14
 
 #define FLUSSPFERD_CD_PARAM(tuple_seq) \
   BOOST_PP_SEQ_FOLD_LEFT( \
@@ -137,13 +145,21 @@ THE SOFTWARE.
   p_constructor_properties, \
   p_custom_enumerate, \
   p_augment_constructor, \
-  p_augment_prototype \
+  p_augment_prototype, \
+  p_deferred_finalize, \
+  p_pooled \
 ) \
   template<typename Class> \
   class BOOST_PP_CAT(p_cpp_name, _base) : public p_base { \
   public: \
     typedef BOOST_PP_CAT(p_cpp_name, _base) base_type; \
     struct class_info : ::flusspferd::class_info { \
+      typedef Class cpp_type; \
+      static constexpr ::flusspferd::detail::class_tag tag = { \
+        ::flusspferd::detail::class_tag_of< p_base >::get(), \
+        (p_deferred_finalize), \
+        (p_full_name) \
+      }; \
       typedef boost::mpl::bool_< (p_constructible) > constructible; \
       static char const *constructor_name() { \
         return (p_constructor_name); \
@@ -173,39 +189,96 @@ THE SOFTWARE.
       } \
       typedef boost::mpl::bool_< (p_custom_enumerate) > custom_enumerate; \
     }; \
-    BOOST_PP_REPEAT( \
-      BOOST_PP_INC(FLUSSPFERD_PARAM_LIMIT), \
-      FLUSSPFERD_CD_CTOR_FWD, \
-      (BOOST_PP_CAT(p_cpp_name, _base), p_base)) \
+    static void *operator new(::std::size_t n) { \
+      return ::flusspferd::detail::pooled_allocate<Class, (p_pooled)>(n); \
+    } \
+    static void operator delete(void *p, ::std::size_t n) { \
+      ::flusspferd::detail::pooled_free<Class, (p_pooled)>(p, n); \
+    } \
+    static void *operator new(::std::size_t, void *where) { \
+      return where; \
+    } \
+    static void operator delete(void *, void *) {} \
+    template<typename... P> \
+    BOOST_PP_CAT(p_cpp_name, _base)(P &&... p) \
+    : p_base(::std::forward<P>(p)...) \
+    { \
+      this->set_native_class_tag(&class_info::tag); \
+    } \
   }; \
   class p_cpp_name \
   : \
     public BOOST_PP_CAT(p_cpp_name, _base) < p_cpp_name > \
   /* */
 
-#define FLUSSPFERD_CD_CTOR_FWD(z, n, d) \
-  BOOST_PP_EXPR_IF(n, template<) \
-  BOOST_PP_ENUM_PARAMS(n, typename P) \
-  BOOST_PP_EXPR_IF(n, >) \
-  BOOST_PP_TUPLE_ELEM(2, 0, d) \
-  ( \
-    BOOST_PP_ENUM_BINARY_PARAMS(n, P, const &p) \
-  ) \
-  : \
-    BOOST_PP_TUPLE_ELEM(2, 1, d) \
-    ( \
-      BOOST_PP_ENUM_PARAMS(n, p) \
-    ) \
-  { } \
+/*
+ * Methods and accessors are installed from static JSFunctionSpec /
+ * JSPropertySpec tables whose entries point to trampolines generated per
+ * bound function, so loading a class does not allocate a function object per
+ * method. Aliases, constants and variables are defined afterwards.
+ */
+
+#define FLUSSPFERD_CD_THUNK(p_bound, p_method) \
+  ::flusspferd::detail::static_function_thunk< & Class :: p_bound, p_method > \
+  /* */
+
+#define FLUSSPFERD_CD_NATIVE_SPEC(p_bound, p_method) \
+  ::flusspferd::Impl::native_spec< FLUSSPFERD_CD_THUNK(p_bound, p_method) > \
   /* */
 
 #define FLUSSPFERD_CD_METHODS(p_methods) \
+  { \
+    static ::flusspferd::Impl::function_spec function_specs[] = { \
+      BOOST_PP_SEQ_FOR_EACH( \
+        FLUSSPFERD_CD_METHOD_SPEC, \
+        ~, \
+        FLUSSPFERD_PP_GEN_TUPLE3SEQ(p_methods)) \
+      { 0, 0, 0, 0, 0 } \
+    }; \
+    ::flusspferd::Impl::define_functions(obj, function_specs); \
+  } \
   BOOST_PP_SEQ_FOR_EACH( \
     FLUSSPFERD_CD_METHOD, \
     ~, \
     FLUSSPFERD_PP_GEN_TUPLE3SEQ(p_methods)) \
   /* */
 
+#define FLUSSPFERD_CD_METHOD_SPEC(r, d, p_method) \
+  BOOST_PP_CAT( \
+    FLUSSPFERD_CD_METHOD_SPEC__, \
+    BOOST_PP_TUPLE_ELEM(3, 1, p_method) \
+  ) ( \
+    BOOST_PP_TUPLE_ELEM(3, 0, p_method), \
+    BOOST_PP_TUPLE_ELEM(3, 2, p_method) \
+  ) \
+  /* */
+
+#define FLUSSPFERD_CD_METHOD_SPEC__bind(p_method_name, p_bound) \
+  { \
+    (p_method_name), \
+    & FLUSSPFERD_CD_NATIVE_SPEC(p_bound, true)::call, \
+    FLUSSPFERD_CD_THUNK(p_bound, true)::arity, \
+    0, \
+    0 \
+  }, \
+  /* */
+
+#define FLUSSPFERD_CD_METHOD_SPEC__bind_static(p_method_name, p_bound) \
+  { \
+    (p_method_name), \
+    & FLUSSPFERD_CD_NATIVE_SPEC(p_bound, false)::call, \
+    FLUSSPFERD_CD_THUNK(p_bound, false)::arity, \
+    0, \
+    0 \
+  }, \
+  /* */
+
+#define FLUSSPFERD_CD_METHOD_SPEC__alias(p_method_name, p_alias) \
+  /* */
+
+#define FLUSSPFERD_CD_METHOD_SPEC__none(p_method_name, p_param) \
+  /* */
+
 #define FLUSSPFERD_CD_METHOD(r, d, p_method) \
   BOOST_PP_CAT( \
     FLUSSPFERD_CD_METHOD__, \
@@ -217,17 +290,9 @@ THE SOFTWARE.
   /* */
 
 #define FLUSSPFERD_CD_METHOD__bind(p_method_name, p_bound) \
-  ::flusspferd::create_native_method( \
-      obj, \
-      (p_method_name), \
-      & Class :: p_bound); \
   /* */
 
 #define FLUSSPFERD_CD_METHOD__bind_static(p_method_name, p_bound) \
-  ::flusspferd::create_native_function( \
-      obj, \
-      (p_method_name), \
-      & Class :: p_bound); \
   /* */
 
 #define FLUSSPFERD_CD_METHOD__alias(p_method_name, p_alias) \
@@ -241,12 +306,63 @@ THE SOFTWARE.
   /* */
 
 #define FLUSSPFERD_CD_PROPERTIES(p_properties) \
+  { \
+    static ::flusspferd::Impl::property_spec property_specs[] = { \
+      BOOST_PP_SEQ_FOR_EACH( \
+        FLUSSPFERD_CD_PROPERTY_SPEC, \
+        ~, \
+        FLUSSPFERD_PP_GEN_TUPLE3SEQ(p_properties)) \
+      { 0, 0, 0, 0, 0 } \
+    }; \
+    ::flusspferd::Impl::define_properties(obj, property_specs); \
+  } \
   BOOST_PP_SEQ_FOR_EACH( \
     FLUSSPFERD_CD_PROPERTY, \
     ~, \
     FLUSSPFERD_PP_GEN_TUPLE3SEQ(p_properties)) \
   /* */
 
+#define FLUSSPFERD_CD_PROPERTY_SPEC(r, d, p_property) \
+  BOOST_PP_CAT( \
+    FLUSSPFERD_CD_PROPERTY_SPEC__, \
+    BOOST_PP_TUPLE_ELEM(3, 1, p_property) \
+  ) ( \
+    BOOST_PP_TUPLE_ELEM(3, 0, p_property), \
+    BOOST_PP_TUPLE_ELEM(3, 2, p_property) \
+  ) \
+  /* */
+
+#define FLUSSPFERD_CD_PROPERTY_SPEC__getter_setter(p_property_name, p_param) \
+  { \
+    (p_property_name), \
+    0, \
+    ::flusspferd::Impl::accessor_property_flags, \
+    & FLUSSPFERD_CD_NATIVE_SPEC( \
+        BOOST_PP_TUPLE_ELEM(2, 0, p_param), true)::getter, \
+    & FLUSSPFERD_CD_NATIVE_SPEC( \
+        BOOST_PP_TUPLE_ELEM(2, 1, p_param), true)::setter \
+  }, \
+  /* */
+
+#define FLUSSPFERD_CD_PROPERTY_SPEC__getter(p_property_name, p_param) \
+  { \
+    (p_property_name), \
+    0, \
+    ::flusspferd::Impl::read_only_accessor_property_flags, \
+    & FLUSSPFERD_CD_NATIVE_SPEC(p_param, true)::getter, \
+    0 \
+  }, \
+  /* */
+
+#define FLUSSPFERD_CD_PROPERTY_SPEC__constant(p_property_name, p_param) \
+  /* */
+
+#define FLUSSPFERD_CD_PROPERTY_SPEC__variable(p_property_name, p_param) \
+  /* */
+
+#define FLUSSPFERD_CD_PROPERTY_SPEC__none(p_property_name, p_param) \
+  /* */
+
 #define FLUSSPFERD_CD_PROPERTY(r, d, p_property) \
   BOOST_PP_CAT( \
     FLUSSPFERD_CD_PROPERTY__, \
@@ -258,39 +374,9 @@ THE SOFTWARE.
   /* */
 
 #define FLUSSPFERD_CD_PROPERTY__getter_setter(p_property_name, p_param) \
-  obj.define_property( \
-    (p_property_name), \
-    ::flusspferd::property_attributes( \
-      ::flusspferd::permanent_shared_property, \
-      std::make_shared<flusspferd::function>(::flusspferd::create_native_method( \
-        ::flusspferd::object(), \
-        "$get_" p_property_name, \
-        & Class :: \
-        BOOST_PP_TUPLE_ELEM(2, 0, p_param) \
-      )), \
-      std::make_shared<flusspferd::function>(::flusspferd::create_native_method( \
-        ::flusspferd::object(), \
-        "$set_" p_property_name, \
-        & Class :: \
-        BOOST_PP_TUPLE_ELEM(2, 1, p_param) \
-      )) \
-    ) \
-  ); \
   /* */
 
 #define FLUSSPFERD_CD_PROPERTY__getter(p_property_name, p_param) \
-  obj.define_property( \
-    (p_property_name), \
-    ::flusspferd::property_attributes( \
-      ::flusspferd::permanent_shared_property \
-      | ::flusspferd::read_only_property, \
-      std::make_shared<flusspferd::function>(::flusspferd::create_native_method( \
-        ::flusspferd::object(), \
-        "$get_" p_property_name, \
-        & Class :: p_param \
-      )) \
-    ) \
-  ); \
   /* */
 
 #define FLUSSPFERD_CD_PROPERTY__constant(p_property_name, p_param) \
@@ -415,6 +501,19 @@ FLUSSPFERD_CLASS_DESCRIPTION(
  *     constructor is being generated by flusspferd::load_class (or more
  *     specifically, @c base_type::class_info::create_prototype).
  *     <br>Default: 0</dd>
+ * <dt><em>deferred_finalize</em> (optional)</dt>
+ * <dd><b>{Boolean}</b> Whether the C++ object is destroyed outside of the
+ *     garbage collector, by native_object_base::drain_finalizers. Use it for
+ *     classes with expensive destructors (closing files and the like). The
+ *     destructor may run on another thread and without a current context,
+ *     so it must not use the Javascript engine.
+ *     <br>Default: @c false.</dd>
+ * <dt><em>pooled</em> (optional)</dt>
+ * <dd><b>{Boolean}</b> Whether objects of the class are allocated from a
+ *     per-class pool of same-size blocks instead of the global heap. Good for
+ *     classes with many short-lived instances. See
+ *     flusspferd::object_pool_statistics for the pool's counters.
+ *     <br>Default: @c false.</dd>
  * </dl></dd></dl>
  *
  * <dl><dt><b>Method types:</b></dt>
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define FLUSSPFERD_CONTEXT_HPP
 
 #include "object.hpp"
+#include "gc_stats.hpp"
 #include <boost/shared_ptr.hpp>
 #include <string>
 
@@ -188,6 +189,27 @@ public:
    * @return       The old value of the strict setting
    */
   bool set_strict(bool strict);
+
+  /**
+   * The number of bytes currently held in native buffers created while this
+   * context was current (see gc_allocator and gc_external_size). A buffer
+   * stays counted here until it is freed, even if another context is current
+   * by then.
+   *
+   * Binary, encoding and stream buffers are counted.
+   *
+   * @return The number of bytes.
+   */
+  std::size_t external_bytes() const;
+
+  /**
+   * Get the garbage collection statistics of the context's runtime.
+   *
+   * @return A snapshot of the statistics.
+   *
+   * @see init::gc_stats
+   */
+  flusspferd::gc_stats gc_stats() const;
 };
 
 template<>
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "value.hpp"
 #include "root.hpp"
 #include "exception.hpp"
+#include "array_builder.hpp"
 #include "spidermonkey/string.hpp"
 #include <boost/noncopyable.hpp>
 #include <boost/utility/enable_if.hpp>
@@ -41,6 +42,13 @@ THE SOFTWARE.
 #include <limits>
 #include <vector>
 #include <list>
+#include <map>
+#include <unordered_map>
+#include <array>
+#include <tuple>
+#include <optional>
+#include <span>
+#include <utility>
 
 namespace flusspferd {
 
@@ -153,6 +161,16 @@ struct convert<
     typedef std::numeric_limits<T> limits;
 
     T perform(value const &v) {
+      if (v.is_int()) {
+        int num = v.get_int();
+        bool in_range =
+          num < 0
+          ? limits::is_signed && boost::intmax_t(num) >= boost::intmax_t(limits::min())
+          : boost::uintmax_t(num) <= boost::uintmax_t(limits::max());
+        if (!in_range)
+          throw exception("Not inside integer range", "RangeError");
+        return T(num);
+      }
       double num = v.to_number();
       if (num < double(limits::min()) || num > double(limits::max()))
         throw exception("Not inside integer range", "RangeError");
@@ -247,33 +265,43 @@ struct convert_ptr<T, native_function_base>;
 
 struct convert_container_base {
   struct to_value {
-    value start();
-    void add(value obj, value x);
+    value finish(array_builder &builder);
   };
 
+  // Reads the elements of an Array. The value is checked once by #open and
+  // the elements are then fetched directly, without wrapping them in array
+  // objects again.
   struct from_value {
-    std::size_t length(value obj);
-    value element(value obj, std::size_t i);
+    from_value() : source(0) {}
+
+    std::size_t open(value const &obj);
+    value element(std::size_t i) const;
+
+  private:
+    JSObject *source;
   };
 };
 
+template<typename Container>
+void container_reserve(Container &cont, std::size_t n) {
+  if constexpr (requires { cont.reserve(n); })
+    cont.reserve(n);
+}
+
 template<typename Container>
 struct convert_container {
   struct to_value {
     convert_container_base::to_value base;
 
-    root_value root;
+    arena_root_value root;
 
     typename convert<typename Container::value_type>::to_value item_converter;
 
     value perform(Container const &cont) {
-      root = base.start();
-      for (typename Container::const_iterator it = cont.begin();
-          it != cont.end();
-          ++it)
-      {
-        base.add(root, item_converter.perform(*it));
-      }
+      array_builder builder(cont.size());
+      for (auto const &item : cont)
+        builder.push(item_converter.perform(item));
+      root = base.finish(builder);
       return root;
     }
   };
@@ -286,10 +314,10 @@ struct convert_container {
 
     Container perform(value val) {
       Container result;
-      std::size_t length = base.length(val);
-      result.reserve(length);
+      std::size_t length = base.open(val);
+      container_reserve(result, length);
       for (std::size_t i = 0; i < length; ++i)
-        result.push_back(item_converter.perform(base.element(val, i)));
+        result.push_back(item_converter.perform(base.element(i)));
       return result;
     }
   };
@@ -303,6 +331,172 @@ template<typename T, typename A>
 struct convert< std::list<T, A> >
 : convert_container< std::list<T, A> > {};
 
+template<typename T, std::size_t N>
+struct convert< std::array<T, N> > {
+  typedef typename convert_container< std::array<T, N> >::to_value to_value;
+
+  struct from_value {
+    convert_container_base::from_value base;
+
+    typename convert<T>::from_value item_converter;
+
+    std::array<T, N> perform(value val) {
+      if (base.open(val) != N)
+        throw exception("Array has the wrong length");
+      std::array<T, N> result;
+      for (std::size_t i = 0; i < N; ++i)
+        result[i] = item_converter.perform(base.element(i));
+      return result;
+    }
+  };
+};
+
+template<typename T, std::size_t E>
+struct convert< std::span<T, E> > {
+  typedef typename convert_container< std::span<T, E> >::to_value to_value;
+  typedef void from_value;
+};
+
+template<typename... T>
+struct convert< std::tuple<T...> > {
+  typedef std::index_sequence_for<T...> indices;
+
+  struct to_value {
+    convert_container_base::to_value base;
+
+    arena_root_value root;
+
+    std::tuple<typename convert<T>::to_value...> item_converters;
+
+    value perform(std::tuple<T...> const &x) {
+      array_builder builder(sizeof...(T));
+      push(builder, x, indices());
+      root = base.finish(builder);
+      return root;
+    }
+
+  private:
+    template<std::size_t... I>
+    void push(
+      array_builder &builder,
+      std::tuple<T...> const &x,
+      std::index_sequence<I...>)
+    {
+      (builder.push(std::get<I>(item_converters).perform(std::get<I>(x))), ...);
+    }
+  };
+
+  struct from_value {
+    convert_container_base::from_value base;
+
+    std::tuple<typename convert<T>::from_value...> item_converters;
+
+    std::tuple<T...> perform(value val) {
+      if (base.open(val) != sizeof...(T))
+        throw exception("Array has the wrong length");
+      return read(indices());
+    }
+
+  private:
+    template<std::size_t... I>
+    std::tuple<T...> read(std::index_sequence<I...>) {
+      // Braced initialisation keeps the conversions in element order.
+      return std::tuple<T...>{
+        std::get<I>(item_converters).perform(base.element(I))...
+      };
+    }
+  };
+};
+
+template<typename T>
+struct convert< std::optional<T> > {
+  struct to_value {
+    typename convert<T>::to_value base;
+
+    value perform(std::optional<T> const &x) {
+      if (!x)
+        return value();
+      return base.perform(*x);
+    }
+  };
+
+  struct from_value {
+    typename convert<T>::from_value base;
+
+    std::optional<T> perform(value const &v) {
+      if (v.is_undefined() || v.is_null())
+        return std::nullopt;
+      return base.perform(v);
+    }
+  };
+};
+
+struct convert_map_base {
+  struct to_value {
+    value start();
+    void set(value obj, value key, value val);
+  };
+
+  struct from_value {
+    value keys(value obj);
+    value get(value obj, value key);
+  };
+};
+
+template<typename Map>
+struct convert_map {
+  struct to_value {
+    convert_map_base::to_value base;
+
+    arena_root_value root;
+    arena_root_value key;
+
+    typename convert<typename Map::key_type>::to_value key_converter;
+    typename convert<typename Map::mapped_type>::to_value mapped_converter;
+
+    value perform(Map const &map) {
+      root = base.start();
+      for (auto const &entry : map) {
+        key = key_converter.perform(entry.first);
+        base.set(root, key, mapped_converter.perform(entry.second));
+      }
+      return root;
+    }
+  };
+
+  struct from_value {
+    convert_map_base::from_value base;
+    convert_container_base::from_value key_reader;
+
+    arena_root_value keys;
+
+    typename convert<typename Map::key_type>::from_value key_converter;
+    typename convert<typename Map::mapped_type>::from_value mapped_converter;
+
+    Map perform(value val) {
+      Map result;
+      keys = base.keys(val);
+      std::size_t length = key_reader.open(keys);
+      container_reserve(result, length);
+      for (std::size_t i = 0; i < length; ++i) {
+        value k = key_reader.element(i);
+        result.emplace(
+          key_converter.perform(k),
+          mapped_converter.perform(base.get(val, k)));
+      }
+      return result;
+    }
+  };
+};
+
+template<typename K, typename T, typename C, typename A>
+struct convert< std::map<K, T, C, A> >
+: convert_map< std::map<K, T, C, A> > {};
+
+template<typename K, typename T, typename H, typename P, typename A>
+struct convert< std::unordered_map<K, T, H, P, A> >
+: convert_map< std::unordered_map<K, T, H, P, A> > {};
+
 }
 #endif
 template<typename T>
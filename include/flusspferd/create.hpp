@@ -36,6 +36,9 @@ THE SOFTWARE.
 #include <boost/type_traits/is_function.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <utility>
 #endif
 #include "detail/limit.hpp"
 #include <boost/preprocessor.hpp>
@@ -79,66 +82,28 @@ object create_object(object const &proto = object());
  */
 array create_array(unsigned int length = 0);
 
-#ifndef IN_DOXYGEN
-
-#define FLUSSPFERD_FN_CREATE_NATIVE_OBJECT(z, n_args, d) \
-  template< \
-    typename T \
-    BOOST_PP_ENUM_TRAILING_PARAMS(n_args, typename T) \
-  > \
-  T &create_native_object( \
-    object proto \
-    BOOST_PP_ENUM_TRAILING_BINARY_PARAMS(n_args, T, const & param), \
-    typename boost::enable_if< boost::mpl::not_<\
-      typename T::class_info::custom_enumerate > \
-    >::type * = 0 \
-  ) { \
-    if (proto.is_null()) \
-      proto = current_context().prototype<T>(); \
-    local_root_scope scope; \
-    object obj = detail::create_native_object(proto); \
-    return *(new T(obj BOOST_PP_ENUM_TRAILING_PARAMS(n_args, param))); \
-  } \
-  \
-  template< \
-    typename T \
-    BOOST_PP_ENUM_TRAILING_PARAMS(n_args, typename T) \
-  > \
-  T &create_native_object( \
-    object proto \
-    BOOST_PP_ENUM_TRAILING_BINARY_PARAMS(n_args, T, const & param), \
-    typename boost::enable_if< \
-      typename T::class_info::custom_enumerate >::type * = 0 \
-  ) { \
-    if (proto.is_null()) \
-      proto = current_context().prototype<T>(); \
-    local_root_scope scope; \
-    object obj = detail::create_native_enumerable_object(proto); \
-    return *(new T(obj BOOST_PP_ENUM_TRAILING_PARAMS(n_args, param))); \
-  } \
-  /* */
-
-BOOST_PP_REPEAT(
-  BOOST_PP_INC(FLUSSPFERD_PARAM_LIMIT),
-  FLUSSPFERD_FN_CREATE_NATIVE_OBJECT,
-  ~
-)
-
-#else
-
 /**
  * Create a new native object of type @p T.
  *
+ * The parameters are forwarded to the constructor of @p T, so large
+ * arguments (like a binary::vector_type) can be moved into the new object.
+ *
  * @param T The type of the object's class.
  * @param proto The prototype to be used. If @p null, the class' default
  *          prototype will be used.
- * @param ... The parameters to the constructor of @p T.
+ * @param param The parameters to the constructor of @p T.
  * @return The new object.
  */
-template<typename T>
-T &create_native_object(object const &proto, ...);
-
-#endif
+template<typename T, typename... P>
+T &create_native_object(object proto, P &&... param) {
+  if (proto.is_null())
+    proto = current_context().prototype<T>();
+  local_root_scope scope;
+  object obj = T::class_info::custom_enumerate::value
+             ? detail::create_native_enumerable_object(proto)
+             : detail::create_native_object(proto);
+  return *(new T(obj, std::forward<P>(param)...));
+}
 //@}
 
 /**
@@ -176,30 +141,6 @@ function create_native_function(native_function_base *ptr);
  */
 function create_native_function(object const &o, native_function_base *ptr);
 
-#ifndef IN_DOXYGEN
-
-#define FLUSSPFERD_FN_CREATE_NATIVE_FUNCTION(z, n_args, d) \
-  template< \
-    typename T \
-    BOOST_PP_ENUM_TRAILING_PARAMS(n_args, typename T) \
-  > \
-  object create_native_functor_function( \
-    object const &o \
-    BOOST_PP_ENUM_TRAILING_BINARY_PARAMS(n_args, T, const & param), \
-    typename boost::enable_if_c<!boost::is_function<T>::value>::type * = 0 \
-  ) { \
-    return create_native_function(o, new T(BOOST_PP_ENUM_PARAMS(n_args, param))); \
-  } \
-  /* */
-
-BOOST_PP_REPEAT(
-  BOOST_PP_INC(FLUSSPFERD_PARAM_LIMIT),
-  FLUSSPFERD_FN_CREATE_NATIVE_FUNCTION,
-  ~
-)
-
-#else
-
 /**
  * Create a new native function of type @p F as method of an object.
  *
@@ -209,13 +150,14 @@ BOOST_PP_REPEAT(
  *
  * @param F The functor type.
  * @param o The object to add the method to.
- * @param ... The parameters to pass to the constructor of @p F.
+ * @param param The parameters to pass to the constructor of @p F.
  * @return The new method.
  */
-template<typename F>
-object create_native_functor_function(object const &o, ...);
-
-#endif
+template<typename F, typename... P>
+typename boost::enable_if_c<!boost::is_function<F>::value, object>::type
+create_native_functor_function(object const &o, P &&...param) {
+  return create_native_function(o, new F(std::forward<P>(param)...));
+}
 
 /**
  * Create a new native method of an object.
@@ -254,6 +196,33 @@ function create_native_function(
   return create_native_functor_function<native_function<T,false> >(o, fn, name);
 }
 
+/**
+ * Create a new native method of an object.
+ *
+ * The functor is stored as is, without wrapping it in a boost::function.
+ *
+ * @param T The function signature to use.
+ * @param o The object to add the method to.
+ * @param name The function name.
+ * @param fn The functor to call.
+ * @return The new function.
+ */
+template<typename T, typename F>
+typename boost::enable_if_c<
+  boost::is_function<T>::value &&
+  !boost::is_pointer<F>::value &&
+  !boost::is_same<F, boost::function<T> >::value,
+  function
+>::type
+create_native_function(
+  object const &o,
+  std::string const &name,
+  F const &fn)
+{
+  return create_native_functor_function<native_function<T, false, F> >(
+    o, fn, name);
+}
+
 /**
  * Create a new native method of an object.
  *
@@ -274,6 +243,34 @@ function create_native_method(
   return create_native_functor_function<native_function<T,true> >(o, fn, name);
 }
 
+/**
+ * Create a new native method of an object.
+ *
+ * The first parameter passed will be 'this'. The functor is stored as is,
+ * without wrapping it in a boost::function.
+ *
+ * @param T The function signature to use.
+ * @param o The object to add the method to.
+ * @param name The function name.
+ * @param fn The functor to call.
+ * @return The new function.
+ */
+template<typename T, typename F>
+typename boost::enable_if_c<
+  boost::is_function<T>::value &&
+  !boost::is_pointer<F>::value &&
+  !boost::is_same<F, boost::function<T> >::value,
+  function
+>::type
+create_native_method(
+  object const &o,
+  std::string const &name,
+  F const &fn)
+{
+  return create_native_functor_function<native_function<T, true, F> >(
+    o, fn, name);
+}
+
 /**
  * Create a new native method of an object.
  *
@@ -289,7 +286,8 @@ function create_native_function(
   T *fnptr,
   typename boost::enable_if_c<boost::is_function<T>::value>::type* =0)
 {
-  return create_native_function<T>(o, name, boost::function<T>(fnptr));
+  return create_native_functor_function<native_function<T, false, T*> >(
+    o, fnptr, name);
 }
 
 /**
@@ -309,7 +307,8 @@ function create_native_method(
   T *fnptr,
   typename boost::enable_if_c<boost::is_function<T>::value>::type* =0)
 {
-  return create_native_method<T>(o, name, boost::function<T>(fnptr));
+  return create_native_functor_function<native_function<T, true, T*> >(
+    o, fnptr, name);
 }
 
 /**
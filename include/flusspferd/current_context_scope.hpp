@@ -29,6 +29,9 @@ THE SOFTWARE.
 
 #include "flusspferd/init.hpp"
 #include "flusspferd/context.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include <boost/optional.hpp>
+#include <boost/noncopyable.hpp>
 
 namespace flusspferd {
 
@@ -65,6 +68,32 @@ public:
   }
 };
 
+#ifndef IN_DOXYGEN
+
+namespace Impl {
+
+/*
+ * Load the context of a Spidermonkey callback while in scope.
+ *
+ * Callbacks nearly always arrive from the context that is already current,
+ * in which case nothing has to be done at all. Otherwise the context is
+ * entered through its cached wrapper, so neither path allocates.
+ */
+class callback_context_scope : private boost::noncopyable {
+private:
+  boost::optional<current_context_scope> scope;
+
+public:
+  explicit callback_context_scope(JSContext *ctx) {
+    if (!is_current_context(ctx))
+      scope.emplace(wrap_context(ctx));
+  }
+};
+
+}
+
+#endif
+
 }
 
 #endif /* FLUSSPFERD_CURRENT_CONTEXT_SCOPE_HPP */
@@ -47,6 +47,7 @@ namespace encodings {
     (full_name, "encodings.Transcoder")
     (constructor_name, "Transcoder")
     (constructor_arity, 2)
+    (deferred_finalize, true)
     (methods,
       ("push", bind, push)
       ("close", bind, close)
@@ -104,7 +104,7 @@ struct detail::convert<function> {
   typedef to_value_helper<function> to_value;
 
   struct from_value {
-    root_value root;
+    arena_root_value root;
 
     function perform(value const &v) {
       function f = function(v.to_object());
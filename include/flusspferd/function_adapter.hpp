@@ -27,16 +27,17 @@ THE SOFTWARE.
 #ifndef FLUSSPFERD_FUNCTION_ADAPTER_HPP
 #define FLUSSPFERD_FUNCTION_ADAPTER_HPP
 
-#ifndef PREPROC_DEBUG
 #include "convert.hpp"
 #include "call_context.hpp"
 #include <boost/type_traits/remove_reference.hpp>
 #include <boost/type_traits/remove_pointer.hpp>
 #include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/is_convertible.hpp>
 #include <boost/function.hpp>
-#endif
-#include "detail/limit.hpp"
-#include <boost/preprocessor.hpp>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <type_traits>
 
 namespace flusspferd {
 
@@ -80,234 +81,173 @@ struct ptr_to_native_object_type<
 native_object_base &get_native_object_parameter_ptr(call_context &x);
 
 template<typename T>
-typename T::arg1_type
-get_native_object_parameter(call_context &x) {
+T get_native_object_parameter(call_context &x) {
   native_object_base &p = get_native_object_parameter_ptr(x);
-  return ptr_to_native_object_type<typename T::arg1_type>::get(p);
+  return ptr_to_native_object_type<T>::get(p);
 }
 
+/*
+ * The 'this' parameter of a method: either the native object (by reference
+ * or pointer) or anything an object converts to.
+ */
 template<typename T>
-T get_native_object_parameter2(call_context &x) {
-  native_object_base &p = get_native_object_parameter_ptr(x);
-  return ptr_to_native_object_type<T>::get(p);
+T get_self_parameter(call_context &x) {
+  if constexpr (is_native_object_type<T>::type::value) {
+    return get_native_object_parameter<T>(x);
+  } else {
+    static_assert(boost::is_convertible<object, T>::value,
+                  "the first parameter of a method must accept 'this'");
+    return x.self;
+  }
 }
 
-#define FLUSSPFERD_DECLARE_ARG_CONVERTER(z, i, T) \
-  typename convert<typename T::BOOST_PP_CAT(BOOST_PP_CAT(arg, i), _type)>::from_value \
-  BOOST_PP_CAT(BOOST_PP_CAT(arg, i), _from_value); \
-  /* */
-
-#define FLUSSPFERD_DECLARE_ARG_CONVERTERS(first, last, T) \
-  BOOST_PP_REPEAT_FROM_TO( \
-    first, \
-    BOOST_PP_INC(last), \
-    FLUSSPFERD_DECLARE_ARG_CONVERTER, \
-    T) \
-  /* */
-
-#define FLUSSPFERD_CONVERT_ARG(z, i, offset) \
-  BOOST_PP_COMMA_IF(BOOST_PP_GREATER(i, 1)) \
-  BOOST_PP_CAT(BOOST_PP_CAT(arg, i), _from_value) \
-  .perform((x).arg[BOOST_PP_SUB(BOOST_PP_DEC(i), offset)]) \
-  /* */
-
-#define FLUSSPFERD_CONVERT_ARGS(first, last, offset) \
-  BOOST_PP_REPEAT_FROM_TO( \
-    first, \
-    BOOST_PP_INC(last), \
-    FLUSSPFERD_CONVERT_ARG, \
-    offset) \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_(z, n_args, d) \
-  template<typename T, typename R, typename C> \
-  struct function_adapter<T, false, R, n_args, C> { \
-    typename convert<R>::to_value to_value; \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(1, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      x.result = to_value.perform( \
-        function(FLUSSPFERD_CONVERT_ARGS(1, n_args, 0))); \
-    } \
-    static std::size_t const arity = (n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_R_VOID(z, n_args, d) \
-  template<typename T, typename C> \
-  struct function_adapter<T, false, void, n_args, C> { \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(1, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      (void)x; \
-      function(FLUSSPFERD_CONVERT_ARGS(1, n_args, 0)); \
-    } \
-    static std::size_t const arity = (n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_NATIVE_OBJECT(z, n_args, d) \
-  template<typename T, typename R> \
-  struct function_adapter< \
-    T, true, R, n_args, \
-    typename boost::enable_if< \
-      typename is_native_object_type<typename T::arg1_type>::type \
-    >::type \
-  > \
-  { \
-    typename convert<R>::to_value to_value; \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(2, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      x.result = to_value.perform( \
-        function( \
-          get_native_object_parameter<T>(x) \
-          FLUSSPFERD_CONVERT_ARGS(2, n_args, 1) \
-        )); \
-    } \
-    static std::size_t const arity = BOOST_PP_DEC(n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_NATIVE_OBJECT_R_VOID(z, n_args, d) \
-  template<typename T> \
-  struct function_adapter< \
-    T, true, void, n_args, \
-    typename boost::enable_if< \
-      typename is_native_object_type<typename T::arg1_type>::type \
-    >::type \
-  > \
-  { \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(2, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      function( \
-        get_native_object_parameter<T>(x) \
-        FLUSSPFERD_CONVERT_ARGS(2, n_args, 1) \
-      ); \
-    } \
-    static std::size_t const arity = BOOST_PP_DEC(n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_OBJECT(z, n_args, d) \
-  template<typename T, typename R> \
-  struct function_adapter< \
-    T, true, R, n_args, \
-    typename boost::enable_if< \
-      typename boost::is_convertible<object, typename T::arg1_type>::type \
-    >::type \
-  > \
-  { \
-    typename convert<R>::to_value to_value; \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(2, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      x.result = to_value.perform(function( \
-          x.self \
-          FLUSSPFERD_CONVERT_ARGS(2, n_args, 1) \
-        )); \
-    } \
-    static std::size_t const arity = BOOST_PP_DEC(n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_OBJECT_R_VOID(z, n_args, d) \
-  template<typename T> \
-  struct function_adapter< \
-    T, true, void, n_args, \
-    typename boost::enable_if< \
-      typename boost::is_convertible<object, typename T::arg1_type>::type \
-    >::type \
-  > \
-  { \
-    FLUSSPFERD_DECLARE_ARG_CONVERTERS(2, n_args, T) \
-    void action(T const &function, call_context &x) { \
-      function( \
-        x.self \
-        FLUSSPFERD_CONVERT_ARGS(2, n_args, 1) \
-      ); \
-    } \
-    static std::size_t const arity = BOOST_PP_DEC(n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_ARG_CONVERTER_MEMFN(z, i, d) \
-  typename convert<BOOST_PP_CAT(P, i)>::from_value \
-  BOOST_PP_CAT(BOOST_PP_CAT(arg, BOOST_PP_INC(i)), _from_value);
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_MEMFN(z, n_args, d) \
-  template< \
-    typename T, \
-    typename R \
-    BOOST_PP_ENUM_TRAILING_PARAMS(n_args, typename P) \
-  > \
-  struct function_adapter_memfn< \
-    R (T::*)(BOOST_PP_ENUM_PARAMS(n_args, P)) \
-  > \
-  { \
-    typename convert<R>::to_value to_value; \
-    BOOST_PP_REPEAT(n_args, FLUSSPFERD_DECLARE_ARG_CONVERTER_MEMFN, ~) \
-    template<typename F> \
-    void action(F fun, call_context &x) { \
-      x.result = to_value.perform( \
-        (get_native_object_parameter2<T*>(x)->*fun) \
-          (FLUSSPFERD_CONVERT_ARGS(1, n_args, 0))); \
-    } \
-    static std::size_t const arity = (n_args); \
-  }; \
-  /* */
-
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTER_MEMFN_R_VOID(z, n_args, d) \
-  template< \
-    typename T \
-    BOOST_PP_ENUM_TRAILING_PARAMS(n_args, typename P) \
-  > \
-  struct function_adapter_memfn< \
-    void (T::*)(BOOST_PP_ENUM_PARAMS(n_args, P)) \
-  > \
-  { \
-    BOOST_PP_REPEAT(n_args, FLUSSPFERD_DECLARE_ARG_CONVERTER_MEMFN, ~) \
-    template<typename F> \
-    void action(F fun, call_context &x) { \
-      (get_native_object_parameter2<T*>(x)->*fun) \
-          (FLUSSPFERD_CONVERT_ARGS(1, n_args, 0)); \
-    } \
-    static std::size_t const arity = (n_args); \
-  }; \
-  /* */
-
-#define FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(suffix) \
-  BOOST_PP_REPEAT_FROM_TO( \
-    0, \
-    BOOST_PP_INC(FLUSSPFERD_PARAM_LIMIT), \
-    BOOST_PP_CAT(FLUSSPFERD_DECLARE_FUNCTION_ADAPTER, suffix), \
-    ~) \
-  /* */
-
-template<
-  typename Type,
-  bool Method,
-  typename ResultType = typename Type::result_type,
-  std::size_t Arity = Type::arity,
-  typename Condition = void>
-struct function_adapter;
-
-template<
-  typename F
-> struct function_adapter_memfn;
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_R_VOID)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_NATIVE_OBJECT)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_NATIVE_OBJECT_R_VOID)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_OBJECT)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_OBJECT_R_VOID)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_MEMFN)
-
-FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_MEMFN_R_VOID)
+/*
+ * Convert the Javascript arguments of @p x to Args..., call @p f with the
+ * given leading parameters followed by the converted arguments and store the
+ * converted result. The converters live on the stack for the whole call.
+ */
+template<typename R, typename... Args>
+struct invoke_converted {
+  template<typename F, typename... Prefix>
+  static void call(F &&f, call_context &x, Prefix &&...prefix) {
+    call_(std::index_sequence_for<Args...>(),
+          std::forward<F>(f), x, std::forward<Prefix>(prefix)...);
+  }
+
+private:
+  template<std::size_t... I, typename F, typename... Prefix>
+  static void call_(
+    std::index_sequence<I...>, F &&f, call_context &x, Prefix &&...prefix)
+  {
+    std::tuple<typename convert<Args>::from_value...> from_value;
+    (void)from_value;
+
+    if constexpr (std::is_void<R>::value) {
+      std::invoke(
+        std::forward<F>(f),
+        std::forward<Prefix>(prefix)...,
+        std::get<I>(from_value).perform(x.arg[I])...);
+    } else {
+      typename convert<R>::to_value to_value;
+      x.result = to_value.perform(std::invoke(
+        std::forward<F>(f),
+        std::forward<Prefix>(prefix)...,
+        std::get<I>(from_value).perform(x.arg[I])...));
+    }
+  }
+};
+
+template<typename Signature, bool Method>
+struct function_thunk;
+
+template<typename R, typename... Args>
+struct function_thunk<R (Args...), false> {
+  static std::size_t const arity = sizeof...(Args);
+
+  template<typename F>
+  static void call(F &function, call_context &x) {
+    invoke_converted<R, Args...>::call(function, x);
+  }
+};
+
+template<typename R, typename Self, typename... Args>
+struct function_thunk<R (Self, Args...), true> {
+  static std::size_t const arity = sizeof...(Args);
+
+  template<typename F>
+  static void call(F &function, call_context &x) {
+    invoke_converted<R, Args...>::call(
+      function, x, get_self_parameter<Self>(x));
+  }
+};
+
+template<typename F>
+struct function_adapter_memfn;
+
+template<typename R, typename T, typename... Args>
+struct function_adapter_memfn<R (T::*)(Args...)> {
+  static std::size_t const arity = sizeof...(Args);
+
+  template<typename F>
+  static void call(F fun, call_context &x) {
+    invoke_converted<R, Args...>::call(
+      fun, x, get_native_object_parameter<T*>(x));
+  }
+};
+
+template<typename R, typename T, typename... Args>
+struct function_adapter_memfn<R (T::*)(Args...) const> {
+  static std::size_t const arity = sizeof...(Args);
+
+  template<typename F>
+  static void call(F fun, call_context &x) {
+    invoke_converted<R, Args...>::call(
+      fun, x, get_native_object_parameter<T*>(x));
+  }
+};
+
+/*
+ * Call a function or member function that is known at compile time, as bound
+ * by FLUSSPFERD_CLASS_DESCRIPTION. Functions and member functions taking a
+ * call_context are called directly, everything else goes through the same
+ * argument conversion as function_adapter.
+ */
+template<auto Fn, bool Method>
+struct static_function_thunk {
+  typedef decltype(Fn) function_type;
+
+  template<typename F>
+  struct traits {
+    typedef typename boost::remove_pointer<F>::type signature;
+
+    static bool const direct =
+      std::is_same<signature, void (call_context &)>::value;
+    static unsigned const arity =
+      direct ? 0 : function_thunk<signature, Method>::arity;
+
+    static void call(call_context &x) {
+      if constexpr (direct) {
+        Fn(x);
+      } else {
+        F fun = Fn;
+        function_thunk<signature, Method>::call(fun, x);
+      }
+    }
+  };
+
+  template<typename T>
+  struct traits<void (T::*)(call_context &)> {
+    static unsigned const arity = 0;
+
+    static void call(call_context &x) {
+      (get_native_object_parameter<T*>(x)->*Fn)(x);
+    }
+  };
+
+  template<typename R, typename T, typename... Args>
+  struct traits<R (T::*)(Args...)> {
+    static unsigned const arity = sizeof...(Args);
+
+    static void call(call_context &x) {
+      function_adapter_memfn<R (T::*)(Args...)>::call(Fn, x);
+    }
+  };
+
+  template<typename R, typename T, typename... Args>
+  struct traits<R (T::*)(Args...) const> {
+    static unsigned const arity = sizeof...(Args);
+
+    static void call(call_context &x) {
+      function_adapter_memfn<R (T::*)(Args...) const>::call(Fn, x);
+    }
+  };
+
+  static unsigned const arity = traits<function_type>::arity;
+
+  static void call(call_context &x) {
+    traits<function_type>::call(x);
+  }
+};
 
 }
 
@@ -316,16 +256,26 @@ FLUSSPFERD_DECLARE_FUNCTION_ADAPTERS(_MEMFN_R_VOID)
 /**
  * Function adapter.
  *
+ * Converts the arguments, calls the function and converts the result. The
+ * argument conversion is generated inline for the signature @p T, so there is
+ * no limit on the number of parameters.
+ *
+ * @param T The function signature.
+ * @param Method Whether the first parameter of @p T receives 'this'.
+ * @param F The type of the stored callable. Defaults to
+ *          <code>boost::function<T></code>, but function pointers and other
+ *          functors can be stored directly.
+ *
  * @ingroup functions
  */
-template<typename T, bool Method>
+template<typename T, bool Method, typename F = boost::function<T> >
 class function_adapter {
 public:
   typedef T spec_type;
-  typedef boost::function<spec_type> function_type;
+  typedef F function_type;
 
 private:
-  typedef detail::function_adapter<function_type, Method> adapter_type;
+  typedef detail::function_thunk<spec_type, Method> adapter_type;
 
 public:
   function_adapter(function_type const &function)
@@ -333,8 +283,7 @@ public:
   {}
 
   void operator() (call_context &x) {
-    adapter_type function_adapter_implementation;
-    function_adapter_implementation.action(function, x);
+    adapter_type::call(function, x);
   }
 
   static std::size_t const arity = adapter_type::arity;
@@ -361,8 +310,7 @@ public:
   {}
 
   void operator() (call_context &x) {
-    adapter_type function_adapter_implementation_memfn;
-    function_adapter_implementation_memfn.action(funptr, x);
+    adapter_type::call(funptr, x);
   }
 
   static std::size_t const arity = adapter_type::arity;
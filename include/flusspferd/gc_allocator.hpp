@@ -0,0 +1,175 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_GC_ALLOCATOR_HPP
+#define FLUSSPFERD_GC_ALLOCATOR_HPP
+
+#include <boost/shared_ptr.hpp>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace flusspferd {
+
+#ifndef IN_DOXYGEN
+namespace detail {
+
+/*
+ * The external byte total of a context. Buffers keep the counter of the
+ * context they were allocated in, so a free is subtracted from that context
+ * whichever context is current, and a buffer may outlive its context.
+ */
+struct gc_counter {
+  gc_counter() : bytes(0) {}
+
+  std::atomic<std::size_t> bytes;
+};
+
+boost::shared_ptr<gc_counter> current_gc_counter();
+
+void *gc_malloc(std::size_t n);
+void gc_free(void *p);
+
+// Count n bytes towards the runtime's malloc counter without allocating.
+void gc_report(std::size_t n);
+
+}
+#endif
+
+/**
+ * Allocator for native buffers owned by Javascript objects.
+ *
+ * Allocations are reported to the runtime's malloc counter, so a growing
+ * buffer makes the garbage collector run just like Javascript allocations
+ * would, and are added to context::external_bytes of the context that was
+ * current when the allocator was created.
+ *
+ * @ingroup gc
+ */
+template<typename T>
+class gc_allocator {
+public:
+  typedef T value_type;
+
+  // A buffer stays charged to its owner's context when it is moved or
+  // swapped into another container; copies are charged to the current one.
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+  typedef std::false_type is_always_equal;
+
+  gc_allocator() : counter(detail::current_gc_counter()) {}
+
+  template<typename U>
+  gc_allocator(gc_allocator<U> const &o) : counter(o.counter) {}
+
+  gc_allocator select_on_container_copy_construction() const {
+    return gc_allocator();
+  }
+
+  T *allocate(std::size_t n) {
+    T *p = static_cast<T*>(detail::gc_malloc(n * sizeof(T)));
+    if (counter)
+      counter->bytes += n * sizeof(T);
+    return p;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    detail::gc_free(p);
+    if (counter)
+      counter->bytes -= n * sizeof(T);
+  }
+
+  template<typename U>
+  bool operator==(gc_allocator<U> const &o) const {
+    return counter == o.counter;
+  }
+
+  template<typename U>
+  bool operator!=(gc_allocator<U> const &o) const {
+    return counter != o.counter;
+  }
+
+private:
+  template<typename U> friend class gc_allocator;
+
+  boost::shared_ptr<detail::gc_counter> counter;
+};
+
+/**
+ * Reports the size of a buffer that is not allocated with gc_allocator.
+ *
+ * For buffers that have to be plain standard containers, for example because
+ * they are adopted from the caller. Call #update after the buffer changed.
+ * The size is kept in context::external_bytes of the context that was
+ * current on construction until the object is destroyed. Growth is also
+ * reported to the runtime's malloc counter on Spidermonkey 1.8.5 and newer;
+ * older engines have no call for that, so there only gc_scheduler (through
+ * gc_scheduler::config::external_growth) acts on it.
+ *
+ * @ingroup gc
+ */
+class gc_external_size {
+public:
+  gc_external_size() : counter(detail::current_gc_counter()), bytes(0) {}
+
+  ~gc_external_size() {
+    if (counter)
+      counter->bytes -= bytes;
+  }
+
+  /**
+   * Set the current size of the buffer.
+   *
+   * @param n The number of bytes.
+   */
+  void update(std::size_t n) {
+    if (n == bytes)
+      return;
+    if (n > bytes)
+      detail::gc_report(n - bytes);
+    if (counter)
+      counter->bytes += n - bytes;
+    bytes = n;
+  }
+
+  /// The size last set with #update.
+  std::size_t size() const {
+    return bytes;
+  }
+
+private:
+  gc_external_size(gc_external_size const &);
+  gc_external_size &operator=(gc_external_size const &);
+
+  boost::shared_ptr<detail::gc_counter> counter;
+  std::size_t bytes;
+};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_GC_SCHEDULER_HPP
+#define FLUSSPFERD_GC_SCHEDULER_HPP
+
+#include "init.hpp"
+#include <boost/noncopyable.hpp>
+#include <chrono>
+#include <cstddef>
+
+namespace flusspferd {
+
+/**
+ * Moves garbage collections into the idle time of a host main loop.
+ *
+ * Call #tick once per iteration of the main loop with the time that can be
+ * spent before the next piece of work is due. Depending on how much the heap
+ * and the native buffers (context::external_bytes) have grown since the last
+ * collection, the allocation rate, the time since the last collection and the
+ * length of previous pauses, the scheduler runs a full collection, lets the
+ * engine decide (<code>JS_MaybeGC</code>) or does nothing. The rest of the
+ * budget is spent on native_object_base::drain_finalizers.
+ *
+ * @code
+flusspferd::gc_scheduler scheduler;
+for (;;) {
+  run_pulse();
+  scheduler.tick(time_until_next_pulse());
+  wait_for_next_pulse();
+}
+@endcode
+ *
+ * @ingroup gc
+ */
+class gc_scheduler : private boost::noncopyable {
+public:
+  /// What #tick did.
+  enum action {
+    /// Nothing: no collection needed or it would not fit into the budget.
+    skipped,
+
+    /// Called <code>JS_MaybeGC</code>.
+    maybe_gc,
+
+    /// Ran a full collection.
+    full_gc
+  };
+
+  /// Thresholds for a full collection.
+  struct config {
+    config()
+      : max_interval(std::chrono::seconds(60)),
+        heap_growth_percent(100),
+        min_heap_growth(1024 * 1024),
+        external_growth(16 * 1024 * 1024)
+    {}
+
+    /// Collect at least this often. An overdue collection is run by the
+    /// next gc_scheduler::tick even if the expected pause does not fit into its budget.
+    std::chrono::steady_clock::duration max_interval;
+
+    /// Heap growth since the last collection, in percent of the heap size
+    /// after it.
+    unsigned heap_growth_percent;
+
+    /// Heap growth (in bytes) below which the heap is never considered grown.
+    std::size_t min_heap_growth;
+
+    /// Growth of context::external_bytes since the last collection.
+    std::size_t external_growth;
+  };
+
+  /**
+   * Create a scheduler for a context.
+   *
+   * @param c The context. Must be current whenever #tick is called.
+   * @param cfg The thresholds.
+   */
+  explicit gc_scheduler(
+    context const &c = current_context(), config const &cfg = config());
+
+  /**
+   * Give the scheduler a chance to collect.
+   *
+   * @param budget The idle time available.
+   * @return What was done.
+   */
+  action tick(std::chrono::microseconds budget);
+
+  /// The thresholds.
+  config &get_config() { return cfg; }
+
+private:
+  bool want_full(std::chrono::steady_clock::time_point now);
+  void collected(std::chrono::steady_clock::time_point now);
+
+  context ctx;
+  config cfg;
+
+  unsigned long seen_collections;
+  std::chrono::steady_clock::time_point last_gc;
+  std::chrono::steady_clock::time_point last_tick;
+  std::size_t heap_after;
+  std::size_t external_after;
+};
+
+}
+
+#endif
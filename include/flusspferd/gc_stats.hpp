@@ -0,0 +1,99 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_GC_STATS_HPP
+#define FLUSSPFERD_GC_STATS_HPP
+
+#include <cstddef>
+
+namespace flusspferd {
+
+/**
+ * Why a garbage collection was run.
+ *
+ * @ingroup gc
+ */
+enum gc_reason {
+  /// Started by the engine (heap or malloc limit reached).
+  gc_reason_automatic,
+
+  /// Requested through context::gc or flusspferd::gc.
+  gc_reason_explicit
+};
+
+/**
+ * Garbage collection statistics of a runtime.
+ *
+ * A snapshot: the counters are updated by a GC callback and can be read from
+ * any thread.
+ *
+ * @see context::gc_stats, init::gc_stats
+ *
+ * @ingroup gc
+ */
+struct gc_stats {
+  /// The number of buckets in #pause_histogram.
+  enum { pause_buckets = 12 };
+
+  /// The number of completed collections.
+  unsigned long collections;
+
+  /// The number of collections with reason gc_reason_explicit.
+  unsigned long explicit_collections;
+
+  /// The sum of all pauses in microseconds.
+  unsigned long long total_pause_us;
+
+  /// The longest pause in microseconds.
+  unsigned long long max_pause_us;
+
+  /// The last pause in microseconds.
+  unsigned long long last_pause_us;
+
+  /// Heap size before the last collection.
+  std::size_t last_bytes_before;
+
+  /// Heap size after the last collection.
+  std::size_t last_bytes_after;
+
+  /// The sum of the bytes reclaimed by all collections.
+  unsigned long long total_bytes_reclaimed;
+
+  /// The reason of the last collection.
+  gc_reason last_reason;
+
+  /**
+   * Pause times. Bucket @c i counts the pauses shorter than 2<sup>i</sup>
+   * milliseconds (and at least 2<sup>i-1</sup>); the last bucket counts all
+   * longer pauses.
+   */
+  unsigned long pause_histogram[pause_buckets];
+};
+
+}
+
+#endif
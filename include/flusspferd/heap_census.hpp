@@ -0,0 +1,106 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_HEAP_CENSUS_HPP
+#define FLUSSPFERD_HEAP_CENSUS_HPP
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace flusspferd {
+
+/**
+ * The live GC things of one kind, as counted by a heap census.
+ *
+ * @see heap_census
+ *
+ * @ingroup gc
+ */
+struct heap_census_entry {
+  /**
+   * What the things are. For objects the name of their JSClass, except for
+   * native objects, which are named by class_info::full_name(). Other things
+   * are named "string", "double" or "xml".
+   */
+  std::string name;
+
+  /// The number of things.
+  std::size_t count;
+
+  /**
+   * Memory owned by the things outside of the GC heap: the characters of
+   * strings and the native_object_base::external_size of native objects.
+   */
+  std::size_t external_bytes;
+};
+
+/**
+ * A census of all live GC things of a runtime.
+ *
+ * @see take_heap_census
+ *
+ * @ingroup gc
+ */
+struct heap_census {
+  /// One entry per kind of thing, sorted by name.
+  std::vector<heap_census_entry> entries;
+
+  /// The number of all things.
+  std::size_t total_count;
+
+  /// The sum of the external bytes of all things.
+  std::size_t total_external_bytes;
+
+  /**
+   * Write the census as text, one line per entry: the count, the external
+   * bytes and the name, separated by tabs. The lines are sorted by name, so
+   * two dumps can be compared with @c diff.
+   *
+   * @param out The stream to write to.
+   */
+  void dump(std::ostream &out) const;
+};
+
+/**
+ * Count all GC things reachable in the current context's runtime.
+ *
+ * Walks the heap from the runtime's roots, so it takes time proportional to
+ * the number of live things. Unreachable things waiting for the next
+ * collection are not counted. Needs SpiderMonkey 1.8 or newer; throws on
+ * older versions.
+ *
+ * @return The census.
+ *
+ * @ingroup gc
+ */
+heap_census take_heap_census();
+
+}
+
+#endif
@@ -28,14 +28,60 @@ THE SOFTWARE.
 #define FLUSSPFERD_INIT_HPP
 
 #include "flusspferd/context.hpp"
+#include "flusspferd/gc_stats.hpp"
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <cstddef>
 
 namespace flusspferd {
 
 class context;
 class object;
 
+/**
+ * Garbage collector parameters that can be changed at runtime.
+ *
+ * @see init::set_gc_parameter
+ *
+ * @ingroup gc
+ */
+enum gc_parameter {
+  /// The maximum size of the Javascript heap in bytes.
+  gc_max_bytes,
+
+  /// The number of bytes allocated with <code>JS_malloc</code> (and
+  /// gc_allocator) after which a garbage collection is triggered.
+  gc_max_malloc_bytes,
+
+  /// Heap growth (in percent of the heap size after the last collection)
+  /// that triggers the next collection. Needs Spidermonkey 1.8.1 (build
+  /// with <code>FLUSSPFERD_JS_1_8_1</code> defined, since 1.8.1 cannot be
+  /// told apart from 1.8.0 by JS_VERSION).
+  gc_trigger_factor
+};
+
+/**
+ * Garbage collector configuration for the engine's start-up.
+ *
+ * A value of <code>0</code> keeps the default.
+ *
+ * @see init::configure
+ *
+ * @ingroup gc
+ */
+struct gc_config {
+  gc_config() : max_bytes(0), max_malloc_bytes(0), trigger_factor(0) {}
+
+  /// @see gc_max_bytes
+  std::size_t max_bytes;
+
+  /// @see gc_max_malloc_bytes
+  std::size_t max_malloc_bytes;
+
+  /// @see gc_trigger_factor
+  unsigned trigger_factor;
+};
+
 /**
  * Manage the current context and the initialisation of the Javascript engine.
  *
@@ -87,6 +133,41 @@ public:
    * @return The global #init object (singleton).
    */
   static init &initialize();
+
+  /**
+   * Configure the garbage collector of runtimes created from now on.
+   *
+   * Must be called before #initialize to change the maximum heap size on
+   * Spidermonkey 1.7. If the engine is already initialized in this thread,
+   * the parameters are applied to it immediately.
+   *
+   * @param config The configuration.
+   */
+  static void configure(gc_config const &config);
+
+  /**
+   * Change a garbage collector parameter of the running engine.
+   *
+   * The engine takes 32 bit values; larger values throw an exception.
+   *
+   * @param key The parameter.
+   * @param value The new value.
+   */
+  void set_gc_parameter(gc_parameter key, std::size_t value);
+
+  /**
+   * Get the garbage collection statistics of the engine.
+   *
+   * @return A snapshot of the statistics.
+   */
+  flusspferd::gc_stats gc_stats() const;
+
+  /**
+   * Get the current size of the Javascript heap.
+   *
+   * @return The number of bytes.
+   */
+  std::size_t heap_bytes() const;
 };
 
 /**
@@ -148,6 +229,17 @@ inline void gc() {
   return current_context().gc();
 }
 
+/**
+ * Change a garbage collector parameter of the running engine.
+ *
+ * @see init::set_gc_parameter
+ *
+ * @ingroup gc
+ */
+inline void set_gc_parameter(gc_parameter key, std::size_t value) {
+  init::initialize().set_gc_parameter(key, value);
+}
+
 /**
  * Get a prototype from the current context's prototype registry.
  *
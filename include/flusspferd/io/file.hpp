@@ -37,6 +37,7 @@ FLUSSPFERD_CLASS_DESCRIPTION(
   (full_name, "IO.File")
   (constructor_name, "File")
   (constructor_arity, 1)
+  (deferred_finalize, true)
   (methods,
     ("open", bind, open)
     ("close", bind, close))
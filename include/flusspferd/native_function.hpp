@@ -36,15 +36,19 @@ namespace flusspferd {
 /**
  * Native function.
  *
+ * @param T The function signature.
+ * @param Method Whether the first parameter receives 'this'.
+ * @param F The type of the stored callable.
+ *
  * @ingroup functions
  */
-template<class T = void, bool Method = false>
+template<class T = void, bool Method = false, typename F = boost::function<T> >
 class native_function : public native_function_base {
 private:
-  typedef function_adapter<T, Method> adapter_type;
+  typedef function_adapter<T, Method, F> adapter_type;
 
 public:
-  typedef boost::function<T> callback_type;
+  typedef F callback_type;
 
   native_function(
       callback_type const &cb,
@@ -35,9 +35,12 @@ THE SOFTWARE.
 #include <boost/function.hpp>
 #include <boost/type_traits/is_base_of.hpp>
 #include <boost/type_traits/is_member_function_pointer.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
 #include <boost/any.hpp>
 #include <memory>
 #include <functional>
+#include <cassert>
 
 namespace flusspferd {
 
@@ -48,6 +51,52 @@ class tracer;
 namespace detail {
   object create_native_object(object const &proto);
   object create_native_enumerable_object(object const &proto);
+
+  /*
+   * Type tag of a class generated by FLUSSPFERD_CLASS_DESCRIPTION. Every tag
+   * points to the tag of the base class, so testing whether a native object
+   * derives from a class is a pointer comparison or a short walk up the chain.
+   */
+  struct class_tag {
+    class_tag const *base;
+
+    // Destroy the C++ object in native_object_base::drain_finalizers
+    // instead of the GC's finalize hook.
+    bool deferred_finalize;
+
+    // class_info::full_name(), for diagnostics like the heap census.
+    char const *name;
+  };
+
+  /*
+   * Only classes whose class_info was generated for exactly that class carry
+   * a tag of their own. Everything else (hand-written class_info, classes
+   * derived from a described class without a description of their own) falls
+   * back to dynamic_cast.
+   */
+  template<typename T, typename Enable = void>
+  struct class_tag_of {
+    static bool const value = false;
+
+    static constexpr class_tag const *get() {
+      return 0;
+    }
+  };
+
+  template<typename T>
+  struct class_tag_of<
+    T,
+    typename boost::enable_if<
+      boost::is_same<typename T::class_info::cpp_type, T>
+    >::type
+  >
+  {
+    static bool const value = true;
+
+    static constexpr class_tag const *get() {
+      return &T::class_info::tag;
+    }
+  };
 }
 #endif
 
@@ -78,6 +127,15 @@ public:
    */
   static native_object_base &get_native(object const &o);
 
+  /**
+   * Get the native object associated with a Javascript object, if any.
+   *
+   * Unlike #get_native, this never throws.
+   *
+   * @return A pointer to the object or @c 0 if @p o is not native.
+   */
+  static native_object_base *try_get_native(object const &o);
+
   /**
    * Test if the Javascript object is associated with a native object
    *
@@ -85,6 +143,46 @@ public:
    */
   static bool is_object_native(object const &o);
 
+  /**
+   * Destroy native objects whose finalization was deferred.
+   *
+   * Objects of classes with the <em>deferred_finalize</em> option are only
+   * detached from their Javascript object when it is garbage collected. Their
+   * destructors are run here, so the host decides when (or on which thread)
+   * the expensive teardown happens.
+   *
+   * @param max The maximum number of objects to destroy.
+   * @return The number of objects destroyed.
+   *
+   * @see FLUSSPFERD_CLASS_DESCRIPTION
+   */
+  static std::size_t drain_finalizers(std::size_t max = std::size_t(-1));
+
+  /**
+   * The number of native objects waiting for #drain_finalizers.
+   *
+   * @return The number of objects.
+   */
+  static std::size_t pending_finalizers();
+
+  /**
+   * Virtual method returning the memory the object owns outside of the GC
+   * heap, like buffers. Only used for statistics.
+   *
+   * Default implementation: return 0.
+   *
+   * @return The number of bytes.
+   *
+   * @see take_heap_census
+   */
+  virtual std::size_t external_size() const;
+
+#ifndef IN_DOXYGEN
+  detail::class_tag const *native_class_tag() const {
+    return tag;
+  }
+#endif
+
 public:
   /**
    * Associate with an object if there is no association yet.
@@ -106,7 +204,13 @@ protected:
    * @param o The object to associate with.
    */
   native_object_base(object const &o);
-  native_object_base(){}
+  native_object_base() : tag(0) {}
+
+#ifndef IN_DOXYGEN
+  void set_native_class_tag(detail::class_tag const *t) {
+    tag = t;
+  }
+#endif
 
 protected:
   /**
@@ -274,15 +378,39 @@ private:
 
 private:
   class impl;
-  boost::scoped_ptr<impl> *p;
+
+  detail::class_tag const *tag;
 
   friend class impl;
 #endif
 };
 
+#ifndef IN_DOXYGEN
+namespace detail {
+
+template<typename T>
+T *native_cast(native_object_base &o) {
+  if constexpr (class_tag_of<T>::value) {
+    T *ptr = 0;
+    for (class_tag const *t = o.native_class_tag(); t; t = t->base) {
+      if (t == class_tag_of<T>::get()) {
+        ptr = static_cast<T*>(&o);
+        break;
+      }
+    }
+    assert(ptr == dynamic_cast<T*>(&o));
+    return ptr;
+  } else {
+    return dynamic_cast<T*>(&o);
+  }
+}
+
+}
+#endif
+
 template<typename T>
 T &cast_to_derived(native_object_base &o) {
-  T *ptr = dynamic_cast<T*>(&o);
+  T *ptr = detail::native_cast<T>(o);
   if (!ptr)
     throw exception("Could not convert native object to derived type");
   return *ptr;
@@ -303,7 +431,44 @@ T &get_native(object const &o) {
 
 template<typename T>
 bool is_derived(native_object_base &o) {
-  return dynamic_cast<T*>(&o);
+  return detail::native_cast<T>(o);
+}
+
+/**
+ * Gets @p o as native object of class @p T, if possible. Never throws.
+ *
+ * @code
+if (flusspferd::binary *b = flusspferd::try_get_native<flusspferd::binary>(o)) {
+  ...
+}
+@endcode
+ *
+ * @param o object to check
+ * @return A pointer to the native object or @c 0 if @p o is null, not native
+ *         or not of class @p T.
+ * @see get_native, as_native
+ * @ingroup classes
+ */
+template<typename T>
+T *try_get_native(object const &o) {
+  native_object_base *p = native_object_base::try_get_native(o);
+  return p ? detail::native_cast<T>(*p) : 0;
+}
+
+/**
+ * Gets @p v as native object of class @p T, if possible. Never throws.
+ *
+ * @param v value to check
+ * @return A pointer to the native object or @c 0 if @p v is not an object,
+ *         not native or not of class @p T.
+ * @see try_get_native
+ * @ingroup classes
+ */
+template<typename T>
+T *as_native(value const &v) {
+  if (!v.is_object())
+    return 0;
+  return try_get_native<T>(v.get_object());
 }
 
 /**
@@ -322,10 +487,7 @@ if (flusspferd::is_native<flusspferd::binary>(o) {
  */
 template<typename T>
 bool is_native(object const &o) {
-  if ( native_object_base::is_object_native(o) ) {
-    return is_derived<T>(native_object_base::get_native(o));
-  }
-  return false;
+  return try_get_native<T>(o);
 }
 
 template<typename T>
@@ -363,7 +525,7 @@ struct convert_ptr<
     typename convert_ptr<native_object_base>::from_value base;
 
     T *perform(value const &v) {
-      return &dynamic_cast<T&>(*base.perform(v));
+      return &cast_to_derived<T>(*base.perform(v));
     }
   };
 };
@@ -30,15 +30,16 @@ THE SOFTWARE.
 #ifndef PREPROC_DEBUG
 #include "spidermonkey/object.hpp"
 #include "property_attributes.hpp"
+#include "property_key.hpp"
 #include "arguments.hpp"
 #include "value.hpp"
 #include "convert.hpp"
 #include "string.hpp"
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 #endif
-#include "detail/limit.hpp"
-#include <boost/preprocessor.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <boost/utility/enable_if.hpp>
 
@@ -187,43 +188,42 @@ public:
 
 #ifndef IN_DOXYGEN
 
-#define FLUSSPFERD_CALL_N(z, n, d) \
-  FLUSSPFERD_CALL_N_2( \
-    n, \
-    BOOST_PP_TUPLE_ELEM(2, 0, d), \
-    BOOST_PP_TUPLE_ELEM(2, 1, d)) \
-  /* */
-
-#define FLUSSPFERD_CALL_N_2(n, f_name, arg_type) \
-  BOOST_PP_EXPR_IF(n, template<) \
-  BOOST_PP_ENUM_PARAMS(n, typename T) \
-  BOOST_PP_EXPR_IF(n, >) \
-  value f_name( \
-    arg_type x \
-    BOOST_PP_ENUM_TRAILING_BINARY_PARAMS(n, T, const &arg)) \
-  { \
-    arguments arg; \
-    BOOST_PP_REPEAT(n, FLUSSPFERD_CALL_ADD_PARAM, ~) \
-    return f_name(x, arg); \
-  } \
-  /* */
-
-#define FLUSSPFERD_CALL_ADD_PARAM(z, n, d) \
-  typename convert<BOOST_PP_CAT(T, n) const &>::to_value BOOST_PP_CAT(c, n); \
-  arg.push_root(BOOST_PP_CAT(c, n).perform(BOOST_PP_CAT(arg, n))); \
-  /* */
-
-#define FLUSSPFERD_CALLS(name, arg_type) \
-  BOOST_PP_REPEAT( \
-    BOOST_PP_INC(FLUSSPFERD_PARAM_LIMIT), \
-    FLUSSPFERD_CALL_N, \
-    (name, arg_type))
-
-FLUSSPFERD_CALLS(apply, object const &)
-FLUSSPFERD_CALLS(call, char const *)
-FLUSSPFERD_CALLS(call, std::string const &)
-FLUSSPFERD_CALLS(call, object const &)
+  template<typename... T>
+  value apply(object const &fn, T const &...params) {
+    arguments arg;
+    push_call_arguments(arg, params...);
+    return apply(fn, arg);
+  }
+
+  template<typename... T>
+  value call(char const *name, T const &...params) {
+    arguments arg;
+    push_call_arguments(arg, params...);
+    return call(name, arg);
+  }
+
+  template<typename... T>
+  value call(std::string const &name, T const &...params) {
+    arguments arg;
+    push_call_arguments(arg, params...);
+    return call(name, arg);
+  }
+
+  template<typename... T>
+  value call(object const &obj, T const &...params) {
+    arguments arg;
+    push_call_arguments(arg, params...);
+    return call(obj, arg);
+  }
+
+private:
+  template<typename... T>
+  static void push_call_arguments(arguments &arg, T const &...params) {
+    (arg.push_root(typename convert<T const &>::to_value().perform(params)),
+     ...);
+  }
 
+public:
 #else // IN_DOXYGEN
   /**
    * Apply a %function to this object.
@@ -334,6 +334,15 @@ FLUSSPFERD_CALLS(call, object const &)
    */
   value set_property(value const &id, value const &v);
 
+  /**
+   * Set a property.
+   *
+   * @param key The property's precomputed key.
+   * @param v The new value.
+   * @return @p v
+   */
+  value set_property(property_key const &key, value const &v);
+
   /**
    * Set a property.
    *
@@ -374,6 +383,14 @@ FLUSSPFERD_CALLS(call, object const &)
    */
   value get_property(value const &id) const;
 
+  /**
+   * Get a property.
+   *
+   * @param key The property's precomputed key.
+   * @return The current value.
+   */
+  value get_property(property_key const &key) const;
+
   /**
    * Get a property (as an object).
    *
@@ -409,6 +426,14 @@ FLUSSPFERD_CALLS(call, object const &)
    */
   bool has_property(value const &id) const;
 
+  /**
+   * Check whether a property exists on the object or any of its prototypes.
+   *
+   * @param key The property's precomputed key.
+   * @return Whether the property exists.
+   */
+  bool has_property(property_key const &key) const;
+
   /**
    * Check whether a property exists directly on the object.
    *
@@ -454,6 +479,43 @@ FLUSSPFERD_CALLS(call, object const &)
    */
   void delete_property(value const &id);
 
+  /**
+   * Delete a property from the object.
+   *
+   * @param key The property's precomputed key.
+   */
+  void delete_property(property_key const &key);
+
+  /**
+   * Get several properties at once.
+   *
+   * All properties are read inside a single local root scope. A property
+   * that can not be read does not abort the operation: its exception is
+   * cleared, its value is set to @c undefined and its index is reported.
+   *
+   * As with get_property, the values are not rooted once the call returns.
+   *
+   * @param keys The properties' precomputed keys.
+   * @param[out] values The current values, in the order of @p keys.
+   * @return The indices of the keys that could not be read.
+   */
+  std::vector<std::size_t> get_properties(
+    std::vector<property_key> const &keys,
+    std::vector<value> &values) const;
+
+  /**
+   * Set several properties at once.
+   *
+   * All properties are written inside a single local root scope. A property
+   * that can not be written does not abort the operation: its exception is
+   * cleared and its index is reported.
+   *
+   * @param properties Pairs of precomputed keys and the new values.
+   * @return The indices of the pairs that could not be written.
+   */
+  std::vector<std::size_t> set_properties(
+    std::vector<std::pair<property_key, value> > const &properties);
+
   /**
    * Return a property_iterator to the first property (in arbitrary order).
    *
@@ -497,7 +559,7 @@ struct detail::convert<object>
   typedef to_value_helper<object> to_value;
 
   struct from_value {
-    root_value root;
+    arena_root_value root;
 
     object perform(value const &v) {
       object o = v.to_object();
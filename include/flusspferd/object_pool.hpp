@@ -0,0 +1,143 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_OBJECT_POOL_HPP
+#define FLUSSPFERD_OBJECT_POOL_HPP
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace flusspferd {
+
+/**
+ * Allocation counters of the object pool of a native class.
+ *
+ * @see object_pool_statistics
+ *
+ * @ingroup classes
+ */
+struct object_pool_stats {
+  /// The class' full name.
+  std::string class_name;
+
+  /// The size of the pooled objects.
+  std::size_t object_size;
+
+  /// The number of objects allocated from the pool.
+  unsigned long allocations;
+
+  /// The number of objects returned to the pool.
+  unsigned long frees;
+
+  /// The number of slabs the objects are carved from.
+  std::size_t slabs;
+};
+
+/**
+ * Get the counters of all native object pools.
+ *
+ * A class gets a pool with the <em>pooled</em> option of
+ * FLUSSPFERD_CLASS_DESCRIPTION. The pool is created when the first object is
+ * allocated.
+ *
+ * @return The counters of each pool.
+ *
+ * @ingroup classes
+ */
+std::vector<object_pool_stats> object_pool_statistics();
+
+#ifndef IN_DOXYGEN
+namespace detail {
+
+/*
+ * Hands out blocks of one size, carved from slabs of many blocks. Freed
+ * blocks go to a free list and are reused; slabs are never released. Locked,
+ * because deferred finalizers may free from another thread.
+ */
+class object_pool : private boost::noncopyable {
+public:
+  object_pool(std::size_t size, char const *name);
+
+  void *allocate();
+  void free(void *p);
+
+  object_pool_stats stats();
+
+  object_pool *next_pool() const { return next; }
+
+private:
+  struct block {
+    block *next;
+  };
+
+  boost::mutex mutex;
+  std::size_t size;
+  char const *name;
+  block *free_list;
+  std::vector<char *> slabs;
+  unsigned long allocations;
+  unsigned long frees;
+  object_pool *next;
+};
+
+// Pools live until the process ends (they are never deleted), so objects
+// destroyed late, like deferred finalizers drained at shutdown, are safe.
+template<typename Class>
+object_pool &pool_of() {
+  static object_pool *pool =
+    new object_pool(sizeof(Class), Class::class_info::full_name());
+  return *pool;
+}
+
+template<typename Class, bool Pooled>
+void *pooled_allocate(std::size_t n) {
+  if constexpr (Pooled) {
+    if (n == sizeof(Class))
+      return pool_of<Class>().allocate();
+  }
+  return ::operator new(n);
+}
+
+template<typename Class, bool Pooled>
+void pooled_free(void *p, std::size_t n) {
+  if constexpr (Pooled) {
+    if (n == sizeof(Class))
+      return pool_of<Class>().free(p);
+  }
+  ::operator delete(p);
+}
+
+}
+#endif
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_PROPERTY_KEY_HPP
+#define FLUSSPFERD_PROPERTY_KEY_HPP
+
+#include "spidermonkey/property_key.hpp"
+#include <string>
+
+namespace flusspferd {
+
+class value;
+class string;
+
+/**
+ * A precomputed property name or index.
+ *
+ * Every property access by name has to atomize the name first, i.e. look it
+ * up in the runtime's atom table. A property_key does that once, when it is
+ * constructed, and keeps the resulting ID. Accessing a property through a key
+ * skips the lookup altogether, which pays off when host code reads the same
+ * fields on many objects over and over again:
+ *
+ * @code
+static property_key const hp_key("hp");
+
+for (...)
+  total += obj.get_property(hp_key).to_number();
+@endcode
+ *
+ * Names are interned, so keys never need to be rooted and stay valid as long
+ * as the runtime they were created in. Integer keys use the element fast path
+ * (JS_GetElement / JS_SetElement) where possible.
+ *
+ * @see object::get_property, object::set_property, object::has_property,
+ *      object::delete_property
+ *
+ * @ingroup property_types
+ */
+class property_key : public Impl::property_key_impl {
+public:
+  /// Construct an invalid key. It must not be used to access properties.
+  property_key() { }
+
+#ifndef IN_DOXYGEN
+  property_key(Impl::property_key_impl const &k)
+    : Impl::property_key_impl(k)
+  { }
+#endif
+
+  /**
+   * Construct a key for a property name.
+   *
+   * @param name The property name.
+   */
+  explicit property_key(char const *name);
+
+  /**
+   * Construct a key for a property name.
+   *
+   * @param name The property name.
+   */
+  explicit property_key(std::string const &name);
+
+  /**
+   * Construct a key for a property name.
+   *
+   * @param name The property name.
+   */
+  explicit property_key(string const &name);
+
+  /**
+   * Construct a key for an integer index.
+   *
+   * @param index The index.
+   */
+  explicit property_key(int index);
+
+  /**
+   * Construct a key for an arbitrary property ID.
+   *
+   * @param id The property ID.
+   */
+  explicit property_key(value const &id);
+
+  /// Whether the key is an integer index.
+  bool is_index() const {
+    return Impl::is_index_key(*this);
+  }
+
+  /**
+   * The integer index.
+   *
+   * Only meaningful if #is_index() is @c true.
+   */
+  int index() const {
+    return Impl::get_index(*this);
+  }
+
+  /// The key as a value (a string or a number).
+  value to_value() const;
+};
+
+/**
+ * Compare two property_key%s for equality.
+ *
+ * @relates property_key
+ */
+inline bool operator==(property_key const &a, property_key const &b) {
+  return Impl::get_jsid(a) == Impl::get_jsid(b);
+}
+
+/**
+ * Compare two property_key%s for inequality.
+ *
+ * @relates property_key
+ */
+inline bool operator!=(property_key const &a, property_key const &b) {
+  return !(a == b);
+}
+
+}
+
+#endif
@@ -27,7 +27,11 @@ THE SOFTWARE.
 #ifndef FLUSSPFERD_ROOT_VALUE_HPP
 #define FLUSSPFERD_ROOT_VALUE_HPP
 
+#include "spidermonkey/value.hpp"
+#include "spidermonkey/root.hpp"
 #include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <vector>
 
 namespace flusspferd {
 
@@ -37,6 +41,93 @@ class object;
 class string;
 class function;
 class array;
+class tracer;
+
+/**
+ * A block of GC roots in contiguous storage.
+ *
+ * Each detail::root registers itself with <code>JS_AddRoot</code>, which is a
+ * runtime-wide hash table insertion (and a removal on destruction). A
+ * root_arena is registered with the garbage collector once and hands out
+ * slots in a single vector: adding and removing a value is O(1) and does not
+ * touch the engine at all.
+ *
+ * Slots are identified by a #handle that stays valid until it is removed.
+ * Handles of removed slots are reused.
+ *
+ * @see arena_root
+ *
+ * @ingroup gc
+ */
+class root_arena : private boost::noncopyable, private Impl::extra_roots {
+public:
+  /// Identifies a slot.
+  typedef std::size_t handle;
+
+  /// Create an empty arena.
+  root_arena();
+
+  /// Destructor. The remaining values are no longer rooted.
+  ~root_arena();
+
+  /**
+   * Reserve storage.
+   *
+   * @param n The number of slots to reserve.
+   */
+  void reserve(std::size_t n);
+
+  /**
+   * Root a value.
+   *
+   * @param v The value.
+   * @return The handle of the new slot.
+   */
+  handle add(value const &v);
+
+  /**
+   * Stop rooting the value in a slot and release the slot.
+   *
+   * @param h The handle.
+   */
+  void remove(handle h);
+
+  /**
+   * Get the value in a slot.
+   *
+   * @param h The handle.
+   * @return The value.
+   */
+  value get(handle h) const;
+
+  /**
+   * Replace the value in a slot.
+   *
+   * @param h The handle.
+   * @param v The new value.
+   */
+  void set(handle h, value const &v);
+
+  /// The number of slots in use.
+  std::size_t size() const {
+    return slots.size() - free_slots.size();
+  }
+
+  /**
+   * The arena of the current thread.
+   *
+   * Used by arena_root unless another arena is given.
+   */
+  static root_arena &current();
+
+private:
+#ifndef IN_DOXYGEN
+  void trace(tracer &trc);
+
+  std::vector<jsval> slots;
+  std::vector<handle> free_slots;
+#endif
+};
 
 namespace detail {
 
@@ -95,6 +186,47 @@ private:
   void *get_gcptr();
 };
 
+/**
+ * Keeps a Javascript value, object or anything in a slot of a root_arena.
+ *
+ * A drop-in replacement for root that avoids registering a GC root with the
+ * engine for every instance. Like root, it can be used transparently as the
+ * type it roots, but it must be assigned as a whole (through
+ * <code>operator=</code>) to keep its slot up to date.
+ *
+ * @see arena_root_value, arena_root_object, arena_root_string,
+ *      arena_root_function, arena_root_array
+ *
+ * @ingroup gc
+ */
+template<class T>
+class arena_root : public T, private boost::noncopyable {
+public:
+  /**
+   * Take a slot in @p arena.
+   *
+   * @param x The initial value.
+   * @param arena The arena.
+   */
+  arena_root(T const &x = T(), root_arena &arena = root_arena::current());
+
+  /// Destructor. Releases the slot.
+  ~arena_root();
+
+  /// Assignment.
+  arena_root &operator=(T const &o) {
+    T::operator=(o);
+    update();
+    return *this;
+  }
+
+private:
+  void update();
+
+  root_arena &arena;
+  root_arena::handle slot;
+};
+
 }
 
 /**
@@ -117,6 +249,21 @@ typedef detail::root<function> root_function;
 /// Javascript root scope for a flusspferd::array.
 typedef detail::root<array> root_array;
 
+/// Arena root for a flusspferd::value.
+typedef detail::arena_root<value> arena_root_value;
+
+/// Arena root for a flusspferd::object.
+typedef detail::arena_root<object> arena_root_object;
+
+/// Arena root for a flusspferd::string.
+typedef detail::arena_root<string> arena_root_string;
+
+/// Arena root for a flusspferd::function.
+typedef detail::arena_root<function> arena_root_function;
+
+/// Arena root for a flusspferd::array.
+typedef detail::arena_root<array> arena_root_array;
+
 //@}
 
 }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define FLUSSPFERD_SPIDERMONKEY_ARGUMETNS_HPP
 
 #include <vector>
+#include <boost/container/small_vector.hpp>
 #include <js/jsapi.h>
 
 namespace flusspferd {
@@ -39,7 +40,12 @@ class value;
 namespace Impl {
 
 class arguments_impl {
-  std::vector<jsval> values; // values from the user are added here
+public:
+  // Small packs stay on the stack.
+  typedef boost::container::small_vector<jsval, 8> values_type;
+
+private:
+  values_type values; // values from the user are added here
   std::size_t n;
   jsval *argv;
 
@@ -56,8 +62,8 @@ protected:
   jsval *get() { return argv; }
   std::size_t size() const { return n; }
 
-  std::vector<jsval> &data() { return values; }
-  std::vector<jsval> const &data() const { return values; }
+  values_type &data() { return values; }
+  values_type const &data() const { return values; }
   void reset_argv();
 
   bool is_userprovided() const {
@@ -78,12 +84,17 @@ protected:
   };
 
   friend jsval *get_arguments(arguments_impl &);
+  friend jsval const *get_arguments(arguments_impl const &);
 };
 
 inline jsval *get_arguments(arguments_impl &arg) {
   return arg.get();
 }
 
+inline jsval const *get_arguments(arguments_impl const &arg) {
+  return arg.get();
+}
+
 }
 
 #endif
@@ -0,0 +1,96 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_SPIDERMONKEY_FUNCTION_SPEC_HPP
+#define FLUSSPFERD_SPIDERMONKEY_FUNCTION_SPEC_HPP
+
+#include <js/jsapi.h>
+
+namespace flusspferd {
+
+struct call_context;
+class object;
+
+#ifndef IN_DOXYGEN
+
+namespace Impl {
+
+typedef JSFunctionSpec function_spec;
+typedef JSPropertySpec property_spec;
+
+typedef void (*native_thunk)(call_context &);
+
+/*
+ * Shared bodies of the static trampolines: set up a call_context for the
+ * Spidermonkey callback and pass it to the thunk.
+ */
+JSBool call_native_thunk(
+  JSContext *ctx, JSObject *obj, uintN argc, jsval *argv, jsval *rval,
+  native_thunk thunk);
+
+JSBool call_property_thunk(
+  JSContext *ctx, JSObject *obj, jsval *vp, bool set, native_thunk thunk);
+
+void define_functions(object const &obj, function_spec *specs);
+void define_properties(object const &obj, property_spec *specs);
+
+unsigned char const accessor_property_flags =
+  JSPROP_ENUMERATE | JSPROP_PERMANENT | JSPROP_SHARED;
+
+unsigned char const read_only_accessor_property_flags =
+  accessor_property_flags | JSPROP_READONLY;
+
+/*
+ * Static entry points for a thunk type, i.e. a type with a static
+ * call(call_context&) member. Used to fill static JSFunctionSpec and
+ * JSPropertySpec tables, so no function object has to be allocated per
+ * method.
+ */
+template<typename Thunk>
+struct native_spec {
+  static JSBool call(
+    JSContext *ctx, JSObject *obj, uintN argc, jsval *argv, jsval *rval)
+  {
+    return call_native_thunk(ctx, obj, argc, argv, rval, &Thunk::call);
+  }
+
+  static JSBool getter(JSContext *ctx, JSObject *obj, jsval, jsval *vp) {
+    return call_property_thunk(ctx, obj, vp, false, &Thunk::call);
+  }
+
+  static JSBool setter(JSContext *ctx, JSObject *obj, jsval, jsval *vp) {
+    return call_property_thunk(ctx, obj, vp, true, &Thunk::call);
+  }
+};
+
+}
+
+#endif
+
+}
+
+#endif /* FLUSSPFERD_SPIDERMONKEY_FUNCTION_SPEC_HPP */
@@ -29,9 +29,9 @@ THE SOFTWARE.
 
 #include "../init.hpp"
 #include "context.hpp"
+#include "runtime.hpp"
 
 typedef struct JSContext JSContext;
-typedef struct JSRuntime JSRuntime;
 
 namespace flusspferd {
 
@@ -40,10 +40,12 @@ namespace flusspferd {
 namespace Impl {
 
 inline JSContext *current_context() {
-  return get_context(flusspferd::current_context());
+  return current_thread.context;
 }
 
-JSRuntime *get_runtime();
+inline bool is_current_context(JSContext *ctx) {
+  return ctx && current_thread.context == ctx;
+}
 
 }
 
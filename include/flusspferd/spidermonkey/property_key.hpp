@@ -0,0 +1,79 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_SPIDERMONKEY_PROPERTY_KEY_HPP
+#define FLUSSPFERD_SPIDERMONKEY_PROPERTY_KEY_HPP
+
+#include <js/jsapi.h>
+
+namespace flusspferd {
+
+#ifndef IN_DOXYGEN
+
+namespace Impl {
+
+class property_key_impl {
+  jsid id;
+  bool is_int;
+  jsint index;
+
+protected:
+  property_key_impl() : id(0), is_int(false), index(0) { }
+
+  property_key_impl(jsid id, bool is_int, jsint index)
+    : id(id), is_int(is_int), index(index)
+  { }
+
+  friend jsid get_jsid(property_key_impl const &k);
+  friend bool is_index_key(property_key_impl const &k);
+  friend jsint get_index(property_key_impl const &k);
+  friend property_key_impl wrap_jsid(jsid id, bool is_int, jsint index);
+};
+
+inline jsid get_jsid(property_key_impl const &k) {
+  return k.id;
+}
+
+inline bool is_index_key(property_key_impl const &k) {
+  return k.is_int;
+}
+
+inline jsint get_index(property_key_impl const &k) {
+  return k.index;
+}
+
+inline property_key_impl wrap_jsid(jsid id, bool is_int, jsint index) {
+  return property_key_impl(id, is_int, index);
+}
+
+}
+
+#endif
+
+}
+
+#endif /* FLUSSPFERD_SPIDERMONKEY_PROPERTY_KEY_HPP */
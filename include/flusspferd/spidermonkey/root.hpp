@@ -0,0 +1,80 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef FLUSSPFERD_SPIDERMONKEY_ROOT_HPP
+#define FLUSSPFERD_SPIDERMONKEY_ROOT_HPP
+
+namespace flusspferd {
+
+class tracer;
+
+#ifndef IN_DOXYGEN
+
+namespace Impl {
+
+/*
+ * A group of GC roots that is traced by the runtime's extra roots hook
+ * instead of being registered value by value with JS_AddRoot. Linking and
+ * unlinking a group is O(1) however many values it holds, and the storage
+ * behind it may move freely while it is linked.
+ *
+ * Copies start out unlinked; it is up to the owner to link them again.
+ */
+class extra_roots {
+public:
+  extra_roots() : linked(false), prev(0), next(0) {}
+  extra_roots(extra_roots const &) : linked(false), prev(0), next(0) {}
+  extra_roots &operator=(extra_roots const &) { return *this; }
+
+  virtual ~extra_roots() {
+    if (linked)
+      unlink();
+  }
+
+  bool is_linked() const {
+    return linked;
+  }
+
+  void link();
+  void unlink();
+
+  virtual void trace(tracer &trc) = 0;
+
+  static void trace_all(tracer &trc);
+
+private:
+  bool linked;
+  extra_roots *prev;
+  extra_roots *next;
+};
+
+}
+
+#endif
+
+}
+
+#endif /* FLUSSPFERD_SPIDERMONKEY_ROOT_HPP */
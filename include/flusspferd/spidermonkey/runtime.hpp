@@ -27,15 +27,51 @@ THE SOFTWARE.
 #ifndef FLUSSPFERD_SPIDERMONKEY_RUNTIME_HPP
 #define FLUSSPFERD_SPIDERMONKEY_RUNTIME_HPP
 
+typedef struct JSContext JSContext;
 typedef struct JSRuntime JSRuntime;
 
 namespace flusspferd {
 
+class init;
+
 #ifndef IN_DOXYGEN
 
 namespace Impl {
 
-JSRuntime *get_runtime();
+class extra_roots;
+
+/*
+ * Per-thread cache of the engine state. It is kept up to date by
+ * init::enter_current_context / init::leave_current_context, so the hot
+ * lookups below are a single thread-local load. Ownership and teardown of
+ * the init singleton still go through boost's thread specific storage.
+ */
+struct thread_state {
+  init *instance;
+  JSContext *context;
+  JSRuntime *runtime;
+  extra_roots *roots;
+
+  // Set by context::gc so the GC callback can tell explicit collections
+  // from the ones the engine starts by itself.
+  bool explicit_gc;
+};
+
+extern thread_local constinit thread_state current_thread;
+
+JSRuntime *load_runtime();
+
+/*
+ * A number that is different for every runtime the process creates. Unlike
+ * the JSRuntime address it is never reused, so caches of runtime-specific
+ * data (like interned property keys) can be keyed on it.
+ */
+unsigned long runtime_generation();
+
+inline JSRuntime *get_runtime() {
+  JSRuntime *rt = current_thread.runtime;
+  return rt ? rt : load_runtime();
+}
 
 }
 
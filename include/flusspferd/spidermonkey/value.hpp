@@ -28,6 +28,8 @@ THE SOFTWARE.
 #define FLUSSPFERD_SPIDERMONKEY_VALUE_HPP
 
 #include <js/jsapi.h>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_signed.hpp>
 
 namespace flusspferd {
 
@@ -103,13 +105,25 @@ inline value_impl wrap_jsvalp(jsval *p) {
   return value_impl(p);
 }
 
+/*
+ * INT_FITS_IN_JSVAL casts to jsuint first, which truncates 64 bit integers,
+ * so compare in the widest type instead.
+ */
+template<typename T>
+inline bool integer_fits_in_jsval(T const &num) {
+  if (boost::is_signed<T>::value)
+    return boost::intmax_t(num) >= boost::intmax_t(jsint(JSVAL_INT_MIN)) &&
+           boost::intmax_t(num) <= boost::intmax_t(jsint(JSVAL_INT_MAX));
+  else
+    return boost::uintmax_t(num) <= boost::uintmax_t(jsint(JSVAL_INT_MAX));
+}
+
 template<typename T>
 value_impl value_impl::from_integer(T const &num) {
-  if (INT_FITS_IN_JSVAL(num)) {
-    return wrap_jsval(INT_TO_JSVAL(num));
+  if (integer_fits_in_jsval(num)) {
+    return wrap_jsval(INT_TO_JSVAL(jsint(num)));
   } else {
-    //TODO: check range?
-    return from_double(num);
+    return from_double(double(num));
   }
 }
 
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "convert.hpp"
 #include "spidermonkey/string.hpp"
 #include <string>
+#include <string_view>
 
 namespace flusspferd {
 
@@ -82,6 +83,13 @@ public:
    */
   string(std::string const &s);
 
+  /**
+   * Construct a string from a UTF-8 std::string_view.
+   *
+   * @param s The std::string_view.
+   */
+  string(std::string_view s);
+
   /**
    * Construct a string from a UTF-16 std::basic_string.
    *
@@ -89,6 +97,13 @@ public:
    */
   string(std::basic_string<js_char16_t> const &s);
 
+  /**
+   * Construct a string from a UTF-16 std::basic_string_view.
+   *
+   * @param s The std::basic_string_view.
+   */
+  string(std::basic_string_view<js_char16_t> s);
+
 #ifndef IN_DOXYGEN
   string(Impl::string_impl const &s)
     : Impl::string_impl(s)
@@ -148,6 +163,22 @@ public:
    */
   char const *c_str() const;
 
+  /**
+   * Get the whole string as UTF-8.
+   *
+   * Borrows the UTF-8 copy the engine makes for #c_str where that copy holds
+   * the whole string. Strings with embedded NUL characters, or with lone
+   * surrogates the engine cannot encode, are encoded into @p storage
+   * instead (lone surrogates become U+FFFD).
+   *
+   * The result is valid while both the flusspferd::string and @p storage
+   * are valid and unchanged.
+   *
+   * @param storage Buffer for strings that cannot be borrowed.
+   * @return The UTF-8 bytes.
+   */
+  std::string_view utf8_view(std::string &storage) const;
+
   /**
    * Convert to a UTF-16 string.
    *
@@ -204,7 +235,7 @@ struct detail::convert<string> {
   typedef to_value_helper<string> to_value;
 
   struct from_value {
-    root_value root;
+    arena_root_value root;
 
     string perform(value const &v) {
       string s = v.to_string();
@@ -219,7 +250,7 @@ struct detail::convert<char const *> {
   typedef to_value_helper<char const *, string> to_value;
 
   struct from_value {
-    root_value root;
+    arena_root_value root;
 
     char const *perform(value const &v) {
       string s = v.to_string();
@@ -253,6 +284,48 @@ struct detail::convert<std::basic_string<js_char16_t> > {
   };
 };
 
+/*
+ * The string_view conversions root the Javascript string in the converter,
+ * so the view stays valid for as long as the converter lives (for a bound
+ * function: for the duration of the call). Only the UTF-16 view borrows the
+ * string's own characters; the UTF-8 view points to the UTF-8 copy the
+ * engine makes (and caches) for the string, or to a copy kept in the
+ * converter (see string::utf8_view).
+ */
+
+template<>
+struct detail::convert<std::string_view> {
+  typedef to_value_helper<std::string_view, string> to_value;
+
+  struct from_value {
+    arena_root_value root;
+    std::string storage;
+
+    std::string_view perform(value const &v) {
+      string s = v.to_string();
+      root = s;
+      return s.utf8_view(storage);
+    }
+  };
+};
+
+template<>
+struct detail::convert<std::basic_string_view<js_char16_t> > {
+  typedef std::basic_string_view<js_char16_t> view_t;
+
+  typedef to_value_helper<view_t, string> to_value;
+
+  struct from_value {
+    arena_root_value root;
+
+    view_t perform(value const &v) {
+      string s = v.to_string();
+      root = s;
+      return view_t(s.data(), s.length());
+    }
+  };
+};
+
 }
 
 #endif /* FLUSSPFERD_STRING_HPP */
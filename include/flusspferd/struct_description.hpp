@@ -0,0 +1,340 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#ifndef FLUSSPFERD_STRUCT_DESCRIPTION_HPP
+#define FLUSSPFERD_STRUCT_DESCRIPTION_HPP
+
+#ifndef PREPROC_DEBUG
+#include "object.hpp"
+#include "create.hpp"
+#include "convert.hpp"
+#include "call_context.hpp"
+#include "property_key.hpp"
+#include "spidermonkey/function_spec.hpp"
+#include "spidermonkey/runtime.hpp"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#endif
+#include <boost/preprocessor.hpp>
+
+namespace flusspferd {
+
+#ifndef IN_DOXYGEN
+
+namespace Impl {
+
+object create_struct_view(void *ptr, property_spec *specs);
+void *get_struct_view(object const &view, property_spec *specs);
+
+}
+
+namespace detail {
+
+template<typename T>
+struct struct_description;
+
+/*
+ * The interned keys of a struct's fields. Keys belong to a runtime, so they
+ * are cached per thread and recomputed for each new runtime. The cache is
+ * keyed on the runtime generation rather than the JSRuntime address, which
+ * a new runtime may reuse.
+ */
+template<typename T>
+property_key const *struct_keys() {
+  typedef struct_description<T> desc;
+
+  static thread_local unsigned long generation = 0;
+  static thread_local property_key keys[desc::size];
+
+  unsigned long current = Impl::runtime_generation();
+  if (generation != current) {
+    for (std::size_t i = 0; i < desc::size; ++i)
+      keys[i] = property_key(desc::names()[i]);
+    generation = current;
+  }
+  return keys;
+}
+
+template<typename T, std::size_t I>
+struct struct_field {
+  typedef typename std::remove_reference<
+      decltype(std::declval<T&>().*std::get<I>(struct_description<T>::fields()))
+    >::type type;
+
+  static type &get(T &s) {
+    return s.*std::get<I>(struct_description<T>::fields());
+  }
+
+  static type const &get(T const &s) {
+    return s.*std::get<I>(struct_description<T>::fields());
+  }
+};
+
+template<typename T>
+struct convert_struct {
+  typedef struct_description<T> desc;
+  typedef std::make_index_sequence<desc::size> indices;
+
+  struct to_value {
+    arena_root_object root;
+
+    value perform(T const &s) {
+      root = create_object();
+      set_fields(s, struct_keys<T>(), indices());
+      return root;
+    }
+
+  private:
+    template<std::size_t... I>
+    void set_fields(
+      T const &s, property_key const *keys, std::index_sequence<I...>)
+    {
+      (set_field<I>(s, keys[I]), ...);
+    }
+
+    template<std::size_t I>
+    void set_field(T const &s, property_key const &key) {
+      typename convert<typename struct_field<T, I>::type>::to_value c;
+      root.set_property(key, c.perform(struct_field<T, I>::get(s)));
+    }
+  };
+
+  struct from_value {
+    arena_root_object root;
+
+    T perform(value const &v) {
+      root = v.to_object();
+      T result{};
+      get_fields(result, struct_keys<T>(), indices());
+      return result;
+    }
+
+  private:
+    template<std::size_t... I>
+    void get_fields(
+      T &s, property_key const *keys, std::index_sequence<I...>)
+    {
+      (get_field<I>(s, keys[I]), ...);
+    }
+
+    // Missing properties leave the field at its default.
+    template<std::size_t I>
+    void get_field(T &s, property_key const &key) {
+      value x = root.get_property(key);
+      if (x.is_undefined())
+        return;
+      typename convert<typename struct_field<T, I>::type>::from_value c;
+      struct_field<T, I>::get(s) = c.perform(x);
+    }
+  };
+};
+
+template<typename T>
+Impl::property_spec *struct_view_specs();
+
+/*
+ * Accessor of a live view: reads the field without arguments, writes it
+ * with one.
+ */
+template<typename T, std::size_t I>
+struct struct_field_thunk {
+  typedef struct_field<T, I> field;
+
+  static void call(call_context &x) {
+    T &s = *static_cast<T*>(
+      Impl::get_struct_view(x.self, struct_view_specs<T>()));
+    if (x.arg.empty()) {
+      typename convert<typename field::type>::to_value c;
+      x.result = c.perform(field::get(s));
+    } else {
+      typename convert<typename field::type>::from_value c;
+      field::get(s) = c.perform(x.arg[0]);
+    }
+  }
+};
+
+template<typename T, std::size_t... I>
+Impl::property_spec *struct_view_specs(std::index_sequence<I...>) {
+  static Impl::property_spec specs[] = {
+    {
+      struct_description<T>::names()[I],
+      0,
+      Impl::accessor_property_flags,
+      &Impl::native_spec< struct_field_thunk<T, I> >::getter,
+      &Impl::native_spec< struct_field_thunk<T, I> >::setter
+    }...,
+    { 0, 0, 0, 0, 0 }
+  };
+  return specs;
+}
+
+template<typename T>
+Impl::property_spec *struct_view_specs() {
+  return struct_view_specs<T>(
+    std::make_index_sequence<struct_description<T>::size>());
+}
+
+}
+
+#endif
+
+/**
+ * @addtogroup value_types
+ */
+//@{
+
+/**
+ * Create a live Javascript view of a C++ struct described by
+ * #FLUSSPFERD_STRUCT.
+ *
+ * Unlike the conversion generated by #FLUSSPFERD_STRUCT, nothing is copied:
+ * every property of the view reads and writes the corresponding field of
+ * @p s directly. The view does not own @p s. It must be detached with
+ * detach_struct_view() before @p s is destroyed; afterwards, accessing its
+ * properties throws.
+ *
+ * @param s The struct to view.
+ * @return The view object.
+ */
+template<typename T>
+object create_struct_view(T &s) {
+  return Impl::create_struct_view(&s, detail::struct_view_specs<T>());
+}
+
+/**
+ * Get the struct behind a live view.
+ *
+ * @param view The view object.
+ * @return The struct.
+ * @throw exception If @p view is not a live view of a @p T, or if it is
+ *                  detached.
+ */
+template<typename T>
+T &get_struct_view(object const &view) {
+  return *static_cast<T*>(
+    Impl::get_struct_view(view, detail::struct_view_specs<T>()));
+}
+
+/**
+ * Detach a live view from its struct.
+ *
+ * @param view The view object.
+ */
+void detach_struct_view(object const &view);
+
+//@}
+
+}
+
+#ifndef IN_DOXYGEN
+
+#define FLUSSPFERD_STRUCT_NAME(s, d, p_field) \
+  BOOST_PP_STRINGIZE(p_field) \
+  /* */
+
+#define FLUSSPFERD_STRUCT_MEMBER(s, p_type, p_field) \
+  & p_type :: p_field \
+  /* */
+
+#define FLUSSPFERD_STRUCT(p_type, p_fields) \
+  namespace flusspferd { namespace detail { \
+  template<> \
+  struct struct_description< p_type > { \
+    typedef p_type struct_type; \
+    static std::size_t const size = BOOST_PP_SEQ_SIZE(p_fields); \
+    static char const *const *names() { \
+      static char const *const names_[] = { \
+        BOOST_PP_SEQ_ENUM( \
+          BOOST_PP_SEQ_TRANSFORM(FLUSSPFERD_STRUCT_NAME, ~, p_fields)) \
+      }; \
+      return names_; \
+    } \
+    static constexpr auto fields() { \
+      return ::std::make_tuple( \
+        BOOST_PP_SEQ_ENUM( \
+          BOOST_PP_SEQ_TRANSFORM(FLUSSPFERD_STRUCT_MEMBER, p_type, p_fields))); \
+    } \
+  }; \
+  template<> \
+  struct convert< p_type > : convert_struct< p_type > {}; \
+  } } \
+  /* */
+
+#else // IN_DOXYGEN
+
+/**
+ * Describe the fields of a plain C++ struct.
+ *
+ * Generates a flusspferd::convert specialization for @p type, so the struct
+ * can be passed to and returned from native functions and converted with
+ * flusspferd::value / flusspferd::convert. Converting a struct to Javascript
+ * creates a new object with one property per field; converting back copies
+ * every property into the corresponding field, leaving fields whose
+ * property is @c undefined at their default. The property names are the
+ * field names, and they are interned once per thread, so no names are
+ * atomized while copying.
+ *
+ * The fields themselves are converted with their own flusspferd::convert
+ * specializations. They should be value types (numbers, std::string, other
+ * described structs, containers...) and @p type must be default
+ * constructible.
+ *
+ * The macro must be used at global namespace scope, with a fully qualified
+ * @p type.
+ *
+ * @code
+namespace game {
+  struct stats {
+    int hp;
+    int mana;
+    std::string name;
+  };
+}
+
+FLUSSPFERD_STRUCT(game::stats, (hp)(mana)(name))
+
+void export_stats(flusspferd::object &mob, game::stats &s) {
+  mob.set_property("stats", flusspferd::value(s));     // copy
+  mob.set_property("live", flusspferd::create_struct_view(s)); // live view
+}
+@endcode
+ *
+ * @param type The struct.
+ * @param fields The sequence of fields, in the form
+ *               <code>(field1)(field2)...</code>.
+ *
+ * @see flusspferd::create_struct_view
+ *
+ * @ingroup value_types
+ */
+#define FLUSSPFERD_STRUCT(type, fields) ...
+
+#endif // IN_DOXYGEN
+
+#endif
@@ -28,8 +28,11 @@ THE SOFTWARE.
 #define FLUSSPFERD_TRACER_HPP
 
 #include "value.hpp"
-#include <boost/scoped_ptr.hpp>
+#include <map>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace flusspferd {
 
@@ -38,6 +41,18 @@ class value;
 
 /**
  * Garbage collection %tracer.
+ *
+ * A tracer is a small object on the stack; creating one does not allocate.
+ * Besides single values, it traces the elements of common containers in one
+ * call:
+ *
+ * @code
+void trace(flusspferd::tracer &trc) {
+    trc("items", items);       // std::vector<flusspferd::value>
+    trc("handlers", handlers); // std::map<std::string, flusspferd::object>
+    trc("cached", cached);     // std::optional<flusspferd::value>
+}
+@endcode
  *
  * @see native_object_base::trace
  *
@@ -61,13 +76,48 @@ public:
     trace_gcptr(name.c_str(), val.get_gcptr());
   }
 
+  /**
+   * Trace all elements of a vector.
+   *
+   * The elements can be anything the tracer can trace, including other
+   * containers.
+   */
+  template<typename T, typename Alloc>
+  void operator()(char const *name, std::vector<T, Alloc> const &v) {
+    for (T const &x : v)
+      (*this)(name, x);
+  }
+
+  /// Trace all mapped values of a map.
+  template<typename K, typename T, typename Compare, typename Alloc>
+  void operator()(char const *name, std::map<K, T, Compare, Alloc> const &m) {
+    for (auto const &x : m)
+      (*this)(name, x.second);
+  }
+
+  /// Trace all mapped values of an unordered map.
+  template<
+    typename K, typename T, typename Hash, typename Equal, typename Alloc>
+  void operator()(
+    char const *name, std::unordered_map<K, T, Hash, Equal, Alloc> const &m)
+  {
+    for (auto const &x : m)
+      (*this)(name, x.second);
+  }
+
+  /// Trace an optional value, if it is set.
+  template<typename T>
+  void operator()(char const *name, std::optional<T> const &o) {
+    if (o)
+      (*this)(name, *o);
+  }
+
 public: //internal
   tracer(void *opaque);
-  ~tracer();
 
 private:
-  class impl;
-  boost::scoped_ptr<impl> p;
+  void *opaque;
+  void *cx;
 };
 
 }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "spidermonkey/value.hpp"
 #include <string>
+#include <boost/cstdint.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/is_integral.hpp>
 #include <boost/type_traits/is_floating_point.hpp>
@@ -261,6 +262,12 @@ public:
   /// Convert the value to an integral number.
   double to_integral_number(int bits, bool has_negative) const;
 
+  /// Convert the value to a signed 32 bit integer (ECMA ToInt32).
+  boost::int32_t to_int32() const;
+
+  /// Convert the value to an unsigned 32 bit integer (ECMA ToUint32).
+  boost::uint32_t to_uint32() const;
+
   /// Convert the value to a boolean.
   bool to_boolean() const;
 
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "flusspferd/arguments.hpp"
 #include "flusspferd/exception.hpp"
 #include "flusspferd/value.hpp"
+#include "flusspferd/tracer.hpp"
 #include <functional>
 #include <cassert>
 #include <js/jsapi.h>
@@ -76,6 +77,26 @@ arguments::arguments(std::vector<value> const &v)
   : Impl::arguments_impl(v)
 { }
 
+arguments::arguments(arguments const &o)
+  : Impl::arguments_impl(o), Impl::extra_roots()
+{
+  if (o.is_linked())
+    link();
+}
+
+arguments &arguments::operator=(arguments const &o) {
+  Impl::arguments_impl::operator=(o);
+  if (o.is_linked())
+    link();
+  return *this;
+}
+
+void arguments::trace(tracer &trc) {
+  values_type &v = data();
+  for (values_type::iterator it = v.begin(); it != v.end(); ++it)
+    trc.trace_gcptr("argument", &*it);
+}
+
 bool arguments::empty() const {
   return size() == 0;
 }
@@ -100,11 +121,18 @@ void arguments::push_back(value const &v) {
 void arguments::push_root(value const &v) {
   if(!is_userprovided())
     throw exception("trying to push data into system provided argument list");
-  roots.push_back(boost::shared_ptr<root_value>(new root_value(v)));
+  link();
   data().push_back(Impl::get_jsval(v));
   reset_argv();
 }
     
+void arguments::clear() {
+  if(!is_userprovided())
+    throw exception("trying to clear system provided argument list");
+  data().clear();
+  reset_argv();
+}
+
 value arguments::back() {
   if (empty())
     return value();
@@ -26,7 +26,10 @@ THE SOFTWARE.
 
 #include "flusspferd/array.hpp"
 #include "flusspferd/exception.hpp"
+#include "flusspferd/tracer.hpp"
 #include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/value.hpp"
+#include "flusspferd/spidermonkey/object.hpp"
 #include <js/jsapi.h>
 
 using namespace flusspferd;
@@ -77,5 +80,45 @@ void array::set_element(std::size_t index, value const &v_) {
 }
 
 void array::push(value val) {
-	call("push", val);
+  set_element(length(), val);
+}
+
+array_builder::array_builder(std::size_t capacity) {
+  elements.reserve(capacity);
+  link();
+}
+
+array_builder::~array_builder() { }
+
+void array_builder::reserve(std::size_t n) {
+  elements.reserve(n);
+}
+
+void array_builder::push(value const &v) {
+  elements.push_back(Impl::get_jsval(v));
+}
+
+std::size_t array_builder::size() const {
+  return elements.size();
+}
+
+array array_builder::finish() {
+  JSObject *obj = JS_NewArrayObject(
+    Impl::current_context(),
+    elements.size(),
+    elements.empty() ? 0 : &elements[0]);
+
+  if (!obj)
+    throw exception("Could not create array");
+
+  elements.clear();
+
+  return object(Impl::wrap_object(obj));
+}
+
+void array_builder::trace(tracer &trc) {
+  for (std::vector<jsval>::iterator it = elements.begin();
+       it != elements.end();
+       ++it)
+    trc.trace_gcptr("array element", &*it);
 }
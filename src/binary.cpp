@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "flusspferd/evaluate.hpp"
 #include "flusspferd/encodings.hpp"
 #include <sstream>
+#include <utility>
 #include <algorithm>
 
 static char const *DEFAULT_ENCODING = "UTF-8";
@@ -80,6 +81,7 @@ binary::binary(object const &o, call_context &x)
     if (i > 2147483647)
       throw exception("Cannot create binary larger than 2147483647 bytes");
     v_data.resize(i);
+    update_external_size();
     return;
   }
 
@@ -89,14 +91,12 @@ binary::binary(object const &o, call_context &x)
     if (o.is_array()) {
       convert<vector_type>::from_value conv;
       conv.perform(o).swap(v_data);
+      update_external_size();
+      return;
+    } else if (binary *b = flusspferd::try_get_native<binary>(o)) {
+      v_data = b->v_data;
+      update_external_size();
       return;
-    } else {
-      try {
-        binary &b = flusspferd::get_native<binary>(o);
-        v_data = b.v_data;
-        return;
-      } catch (flusspferd::exception&) {
-      }
     }
   }
 
@@ -111,15 +111,26 @@ binary::binary(object const &o, call_context &x)
   arg.push_root(encodings::convert_from_string(encoding, text));
 
   do_append(arg);
+  update_external_size();
 }
 
 binary::binary(object const &o, binary const &b)
   : base_type(o), v_data(b.v_data)
-{}
+{
+  update_external_size();
+}
 
 binary::binary(object const &o, element_type const *p, std::size_t n)
   : base_type(o), v_data(p, p + n)
-{}
+{
+  update_external_size();
+}
+
+binary::binary(object const &o, vector_type &&data)
+  : base_type(o), v_data(std::move(data))
+{
+  update_external_size();
+}
 
 void binary::augment_prototype(object &proto) {
   static const char* js_iterator =
@@ -210,8 +221,13 @@ std::size_t binary::get_length() {
   return v_data.size();
 }
 
+std::size_t binary::external_size() const {
+  return v_data.capacity();
+}
+
 std::size_t binary::set_length(std::size_t n) {
   v_data.resize(n);
+  update_external_size();
   return v_data.size();
 }
 
@@ -349,6 +365,7 @@ void binary::do_append(arguments &arg) {
       }
     }
   }
+  update_external_size();
 }
 
 array binary::split(value delim, object options) {
@@ -409,7 +426,7 @@ array binary::split(value delim, object options) {
   typedef vector_type::iterator iterator;
   iterator pos = v_data.begin();
 
-  array results = create_array();
+  array_builder results;
 
   // Loop only through the first count-1 elements
   for (std::size_t n = 1; n < count; ++n) {
@@ -434,20 +451,20 @@ array binary::split(value delim, object options) {
     binary &elem = create_range(pos, first_found);
 
     // Add element
-    results.call("push", elem);
+    results.push(elem);
 
     // Possible add delimiter
     if (include_delimiter)
-      results.call("push", *delims[delim_id]);
+      results.push(*delims[delim_id]);
 
     // Advance position _after_ the delimiter.
     pos = first_found + delims[delim_id]->get_length();
   }
 
   // Add last element, possibly containing delimiters
-  results.call("push", create_range(pos, v_data.end()));
+  results.push(create_range(pos, v_data.end()));
 
-  return results;
+  return results.finish();
 }
 
 void binary::debug_rep(std::ostream &stream) {
@@ -482,6 +499,10 @@ byte_string::byte_string(object const &o, element_type const *p, std::size_t n)
   : base_type(o, p, n)
 {}
 
+byte_string::byte_string(object const &o, vector_type &&data)
+  : base_type(o, std::move(data))
+{}
+
 binary &byte_string::create(element_type const *p, std::size_t n) {
   return create_native_object<byte_string>(object(), p, n);
 }
@@ -567,6 +588,10 @@ byte_array::byte_array(object const &o, element_type const *p, std::size_t n)
   : base_type(o, p, n)
 {}
 
+byte_array::byte_array(object const &o, vector_type &&data)
+  : base_type(o, std::move(data))
+{}
+
 binary &byte_array::create(element_type const *p, std::size_t n) {
   return create_native_object<byte_array>(object(), p, n);
 }
@@ -605,6 +630,7 @@ void byte_array::prepend(call_context &x) {
   tmp.swap(get_data());
   do_append(x.arg);
   get_data().insert(get_data().end(), tmp.begin(), tmp.end());
+  update_external_size();
   x.result = int(get_length());
 }
 
@@ -661,6 +687,7 @@ void byte_array::displace(call_context &x) {
     arg.push_back(x.arg[i]);
   do_append(arg);
   get_data().insert(get_data().end(), tmp.begin(), tmp.end());
+  update_external_size();
   x.result = int(get_length());
 }
 
@@ -706,6 +733,7 @@ byte_array &byte_array::filter(function callback, object thisObj) {
     if (callback.call(thisObj, v[i], i, *this).to_boolean())
       result.get_data().push_back(v[i]);
   }
+  result.update_external_size();
 
   return result;
 }
@@ -40,7 +40,8 @@ struct binary_device :
     boost::iostreams::bidirectional_seekable>
 {
   explicit binary_device(binary &binary_)
-    : v(binary_.get_data()), pos_read(0), pos_write(0), read_only(true)
+    : b(binary_), v(binary_.get_data()),
+      pos_read(0), pos_write(0), read_only(true)
   {}
 
   std::streamsize read(char *s, std::streamsize n);
@@ -50,7 +51,8 @@ struct binary_device :
     std::ios::seekdir way,
     std::ios::openmode which);
 
-  std::vector<unsigned char> &v;
+  binary &b;
+  binary::vector_type &v;
   std::size_t pos_read;
   std::size_t pos_write;
 
@@ -79,7 +81,7 @@ static binary &get_arg(call_context &x) {
 binary_stream::binary_stream(object const &obj, call_context &x)
   : base_type(obj, (std::streambuf*)0), p(new impl(get_arg(x)))
 {
-  if (dynamic_cast<byte_array*>(&p->binary_)) {
+  if (is_derived<byte_array>(p->binary_)) {
     p->buf->read_only = false;
   }
   set_streambuf(&p->buf);
@@ -115,8 +117,10 @@ std::streamsize binary_device::write(char const *data, std::streamsize n) {
 
   if (n < 0)
     n = 0;
-  if (pos_write + n >= v.size())
+  if (pos_write + n >= v.size()) {
     v.resize(pos_write + n);
+    b.update_external_size();
+  }
   std::memcpy(&v[pos_write], data, n);
   pos_write += n;
   return n;
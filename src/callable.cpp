@@ -0,0 +1,209 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/callable.hpp"
+#include "flusspferd/exception.hpp"
+#include "flusspferd/tracer.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/value.hpp"
+#include "flusspferd/spidermonkey/object.hpp"
+#include "flusspferd/spidermonkey/arguments.hpp"
+#include <js/jsapi.h>
+
+using namespace flusspferd;
+
+call_results::call_results()
+  : n_failures(0)
+{
+  link();
+}
+
+call_results::~call_results() { }
+
+value call_results::result(std::size_t i) const {
+  return entries[i].ok ? entries[i].v : value();
+}
+
+value call_results::error(std::size_t i) const {
+  return entries[i].ok ? value() : entries[i].v;
+}
+
+void call_results::clear() {
+  entries.clear();
+  n_failures = 0;
+}
+
+void call_results::add(value const &v, bool ok) {
+  entry e = { v, ok };
+  entries.push_back(e);
+  if (!ok)
+    ++n_failures;
+}
+
+void call_results::trace(tracer &trc) {
+  for (std::vector<entry>::iterator it = entries.begin();
+       it != entries.end();
+       ++it)
+    trc.trace_gcptr("call result", it->v.get_gcptr());
+}
+
+callable::callable() {
+  link();
+}
+
+callable::callable(object const &self, std::string const &name)
+  : this_(self), name(name)
+{
+  link();
+}
+
+callable::callable(object const &self, object const &fn)
+  : this_(self), fn(fn)
+{
+  link();
+}
+
+callable::~callable() { }
+
+void callable::reset(object const &self, std::string const &name_) {
+  this_ = self;
+  fn = value();
+  name = name_;
+}
+
+void callable::reset(object const &self, object const &fn_) {
+  this_ = self;
+  fn = fn_;
+  name.clear();
+}
+
+void callable::reset() {
+  this_ = object();
+  fn = value();
+  name.clear();
+}
+
+void callable::invalidate() {
+  fn = value();
+  if (name.empty())
+    this_ = object();
+}
+
+bool callable::is_resolved() const {
+  return !fn.is_undefined();
+}
+
+bool callable::empty() const {
+  return this_.is_null() && fn.is_undefined();
+}
+
+object callable::self() const {
+  return this_;
+}
+
+value callable::get_function() const {
+  return fn;
+}
+
+void callable::resolve() {
+  if (is_resolved())
+    return;
+
+  if (this_.is_null() || name.empty())
+    throw exception("Could not resolve callable (handle is empty)");
+
+  value v = this_.get_property(name);
+  if (!v.is_function())
+    throw exception("Could not resolve callable (" + name +
+                    " is not a function)");
+  fn = v;
+}
+
+value callable::call(arguments const &arg) {
+  resolve();
+
+  if (this_.is_null())
+    throw exception("Could not call function (object is null)");
+
+  value result;
+
+  JSContext *cx = Impl::current_context();
+
+  JSBool status = JS_CallFunctionValue(
+      cx,
+      Impl::get_object(this_),
+      Impl::get_jsval(fn),
+      arg.size(),
+      const_cast<jsval*>(Impl::get_arguments(arg)),
+      Impl::get_jsvalp(result));
+
+  if (!status) {
+    if (JS_IsExceptionPending(cx))
+      throw exception("Could not call function");
+    else
+      throw js_quit();
+  }
+
+  return result;
+}
+
+bool callable::call_one(arguments const &arg, call_results &results) {
+  if (this_.is_null())
+    throw exception("Could not call function (object is null)");
+
+  value result;
+
+  JSContext *cx = Impl::current_context();
+
+  JSBool status = JS_CallFunctionValue(
+      cx,
+      Impl::get_object(this_),
+      Impl::get_jsval(fn),
+      arg.size(),
+      const_cast<jsval*>(Impl::get_arguments(arg)),
+      Impl::get_jsvalp(result));
+
+  if (status) {
+    results.add(result, true);
+    return true;
+  }
+
+  // Record the exception value itself. Building a flusspferd::exception
+  // for every failed item would be far more expensive.
+  jsval error;
+  if (!JS_IsExceptionPending(cx) || !JS_GetPendingException(cx, &error))
+    throw js_quit();
+  JS_ClearPendingException(cx);
+
+  results.add(Impl::wrap_jsval(error), false);
+  return false;
+}
+
+void callable::trace(tracer &trc) {
+  trc("callable this", this_);
+  trc.trace_gcptr("callable function", fn.get_gcptr());
+}
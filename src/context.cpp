@@ -33,8 +33,14 @@ THE SOFTWARE.
 #include "flusspferd/spidermonkey/object.hpp"
 #include "flusspferd/spidermonkey/runtime.hpp"
 #include "flusspferd/current_context_scope.hpp"
+#include "flusspferd/gc_allocator.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include <boost/weak_ptr.hpp>
 #include <unordered_map>
 #include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
 #include <cstdio>
 #include <iostream>
 #include <js/jsapi.h>
@@ -58,6 +64,16 @@ struct context::context_private {
   typedef boost::shared_ptr<root_object> root_object_ptr;
   std::unordered_map<std::string, root_object_ptr> prototypes;
   std::unordered_map<std::string, root_object_ptr> constructors;
+
+  // The owning wrapper of the JSContext. Callbacks coming from Spidermonkey
+  // reuse it instead of allocating a fresh, non-owning wrapper each time.
+  boost::weak_ptr<impl> self;
+
+  // Bytes held by gc_allocator buffers (see context::external_bytes).
+  boost::shared_ptr<flusspferd::detail::gc_counter> external;
+
+  context_private() : external(new flusspferd::detail::gc_counter) {}
+
 };
 
 /// impl provides the hidden implementation part
@@ -110,6 +126,7 @@ public:
       {
         current_context_scope scope(Impl::wrap_context(context));
         delete get_private();
+        JS_SetContextPrivate(context, 0);
         JS_DestroyContext(context);
       }
     }
@@ -155,6 +172,15 @@ struct context::detail {
   static JSContext *get(context &co) {
     return co.p->context;
   }
+
+  static boost::shared_ptr<flusspferd::detail::gc_counter>
+  external_bytes(JSContext *cx) {
+    context_private *priv =
+      cx ? static_cast<context_private*>(JS_GetContextPrivate(cx)) : 0;
+    return priv
+      ? priv->external
+      : boost::shared_ptr<flusspferd::detail::gc_counter>();
+  }
 };
 
 JSContext *Impl::get_context(context &co) {
@@ -168,16 +194,25 @@ context Impl::wrap_context(JSContext *c) {
 context::context()
 { }
 context::context(context::detail const &d)
-  : p(new impl(d.c))
 {
-  if (!p->is_valid())
-    p.reset();
+  if (d.c) {
+    context_private *priv =
+      static_cast<context_private*>(JS_GetContextPrivate(d.c));
+    if (priv)
+      p = priv->self.lock();
+  }
+  if (!p) {
+    p.reset(new impl(d.c));
+    if (!p->is_valid())
+      p.reset();
+  }
 }
 context::~context() { }
 
 context context::create() {
   context c;
   c.p.reset(new impl);
+  c.p->get_private()->self = c.p;
   return c;
 }
 
@@ -227,8 +262,50 @@ object context::constructor(std::string const &name) const {
   return ptr ? *ptr : object();
 }
 
+std::size_t context::external_bytes() const {
+  return p->get_private()->external->bytes;
+}
+
+boost::shared_ptr<detail::gc_counter> detail::current_gc_counter() {
+  return context::detail::external_bytes(Impl::current_context());
+}
+
+// JS_malloc adds the size to the runtime's malloc counter, which triggers a
+// GC once it passes the runtime's limit. Frees cannot be reported to the
+// engine (the counter is reset by every GC), only to our own totals.
+void *detail::gc_malloc(std::size_t n) {
+  JSContext *cx = Impl::current_context();
+  void *p = cx ? JS_malloc(cx, n) : std::malloc(n);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void detail::gc_free(void *p) {
+  std::free(p);
+}
+
+// Engines before 1.8.5 have no call that only updates the malloc counter.
+// There the bytes are only in the context's external total, which
+// gc_scheduler compares against config::external_growth.
+void detail::gc_report(std::size_t n) {
+#if JS_VERSION >= 185
+  JSContext *cx = Impl::current_context();
+  if (cx && n)
+    JS_updateMallocCounter(cx, n);
+#else
+  (void) n;
+#endif
+}
+
+gc_stats context::gc_stats() const {
+  return init::initialize().gc_stats();
+}
+
 void context::gc() {
+  Impl::current_thread.explicit_gc = true;
   JS_GC(p->context);
+  Impl::current_thread.explicit_gc = false;
 }
 
 void context::set_thread() {
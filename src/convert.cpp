@@ -26,24 +26,67 @@ THE SOFTWARE.
 #include "flusspferd/convert.hpp"
 #include "flusspferd/array.hpp"
 #include "flusspferd/create.hpp"
+#include "flusspferd/property_iterator.hpp"
+#include "flusspferd/exception.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/object.hpp"
+#include "flusspferd/spidermonkey/value.hpp"
+#include <js/jsapi.h>
 
 using namespace flusspferd;
 using detail::convert_container_base;
+using detail::convert_map_base;
 
-value convert_container_base::to_value::start() {
-  return create_array();
+value convert_container_base::to_value::finish(array_builder &builder) {
+  return builder.finish();
 }
 
-void convert_container_base::to_value::add(value obj, value el) {
-  obj.to_object().call("push", el);
+std::size_t convert_container_base::from_value::open(value const &obj) {
+  if (!obj.is_object() || obj.is_null())
+    throw exception("Value is not an array");
+
+  JSContext *ctx = Impl::current_context();
+  JSObject *o = Impl::get_object(obj.get_object());
+
+  if (!JS_IsArrayObject(ctx, o))
+    throw exception("Object is not array");
+
+  jsuint length;
+  if (!JS_GetArrayLength(ctx, o, &length))
+    throw exception("Could not get array length");
+
+  source = o;
+  return length;
+}
+
+value convert_container_base::from_value::element(std::size_t i) const {
+  value result;
+  if (!JS_GetElement(Impl::current_context(), source, i,
+                     Impl::get_jsvalp(result)))
+    throw exception("Could not get array element");
+  return result;
 }
 
-std::size_t convert_container_base::from_value::length(value obj_v) {
-  array arr(obj_v.to_object());
-  return arr.length();
+value convert_map_base::to_value::start() {
+  return create_object();
+}
+
+void convert_map_base::to_value::set(value obj, value key, value val) {
+  obj.get_object().set_property(key, val);
+}
+
+value convert_map_base::from_value::keys(value obj) {
+  if (!obj.is_object() || obj.is_null())
+    throw exception("Value is not an object");
+
+  object o = obj.get_object();
+
+  array_builder builder;
+  for (property_iterator it = o.begin(); it != o.end(); ++it)
+    builder.push(*it);
+  return builder.finish();
 }
 
-value convert_container_base::from_value::element(value obj_v, std::size_t i) {
-  array arr(obj_v.to_object());
-  return arr.get_element(i);
+value convert_map_base::from_value::get(value obj, value key) {
+  return obj.get_object().get_property(key);
 }
@@ -123,8 +123,14 @@ public:
       iconv_close(conv);
   }
 
+  // Reports both buffers to the GC; called after every push and close.
+  void update_external_size() {
+    size.update(accumulator.capacity() + multibyte_part.capacity());
+  }
+
   binary::vector_type accumulator;
   binary::vector_type multibyte_part;
+  gc_external_size size;
 
   iconv_t conv;
 };
@@ -180,11 +186,14 @@ binary &encodings::transcoder::push(
   append_accumulator(output);
   do_push(input, output.get_data());
 
+  output.update_external_size();
+  p->update_external_size();
   return output;
 }
 
 void encodings::transcoder::push_accumulate(binary &input) {
   do_push(input, p->accumulator);
+  p->update_external_size();
 }
 
 binary &encodings::transcoder::close(
@@ -216,6 +225,8 @@ binary &encodings::transcoder::close(
     p->conv = iconv_t(-1);
   }
 
+  output.update_external_size();
+  p->update_external_size();
   return output;
 }
 
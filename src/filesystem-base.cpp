@@ -444,15 +444,15 @@ array fs_base::list(std::string const &dir) {
   }
 
 
-  root_array ret(create_array());
+  array_builder ret;
 
   fs::directory_iterator it(dir);
 
   for (;  it != fs::directory_iterator(); ++it) {
-    ret.call("push", it->path().string());
+    ret.push(value(it->path().string()));
   }
 
-  return ret;
+  return ret.finish();
 }
 
 #ifdef FLUSSPFERD_HAVE_POSIX
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include <cstring>
 #include <cstdlib>
 #include <cctype>
+#include <cerrno>
+#include <limits>
 #include <string>
 #include <list>
 
@@ -69,6 +71,7 @@ class flusspferd_repl {
 
   flusspferd::context co;
   flusspferd::current_context_scope scope;
+  flusspferd::gc_scheduler gc_scheduler;
 
   bool running;
   int exit_code;
@@ -120,6 +123,7 @@ flusspferd_repl::flusspferd_repl(int argc, char **argv)
     config_file(INSTALL_PREFIX "/etc/flusspferd/jsrepl.js"),
     co(flusspferd::context::create()),
     scope(flusspferd::current_context_scope(co)),
+    gc_scheduler(co),
     running(false),
     exit_code(0),
     history_file(HISTORY_FILE_DEFAULT),
@@ -273,7 +277,9 @@ void flusspferd_repl::repl_loop() {
     catch(std::exception &e) {
       std::cerr << "ERROR: " << e.what() << '\n';
     }
-    flusspferd::gc();
+
+    // The user is reading the output now, so there is time to collect.
+    gc_scheduler.tick(std::chrono::milliseconds(50));
   }
 
 #ifdef HAVE_EDITLINE
@@ -453,6 +459,26 @@ flusspferd::object flusspferd_repl::option_spec() {
                     args::arg2, MainModule, true)
     ));
 
+  // The --gc-* options are applied by configure_gc before the engine starts;
+  // they are listed here so getopt accepts and documents them.
+  flusspferd::object gc_max_bytes(flusspferd::create_object());
+  spec.set_property("gc-max-bytes", gc_max_bytes);
+  gc_max_bytes.set_property("doc", "Set the maximum Javascript heap size in bytes.");
+  gc_max_bytes.set_property("argument", "required");
+  gc_max_bytes.set_property("argument_type", "bytes");
+
+  flusspferd::object gc_max_malloc_bytes(flusspferd::create_object());
+  spec.set_property("gc-max-malloc-bytes", gc_max_malloc_bytes);
+  gc_max_malloc_bytes.set_property("doc", "Run the GC after this many bytes of native allocations.");
+  gc_max_malloc_bytes.set_property("argument", "required");
+  gc_max_malloc_bytes.set_property("argument_type", "bytes");
+
+  flusspferd::object gc_trigger_factor(flusspferd::create_object());
+  spec.set_property("gc-trigger-factor", gc_trigger_factor);
+  gc_trigger_factor.set_property("doc", "Run the GC when the heap has grown to this percentage of its size after the last GC.");
+  gc_trigger_factor.set_property("argument", "required");
+  gc_trigger_factor.set_property("argument_type", "percent");
+
   flusspferd::object no_global_history(flusspferd::create_object());
   spec.set_property("no-global-history", no_global_history);
   no_global_history.set_property("doc", "Do not use a global history in interactive mode.");
@@ -490,10 +516,12 @@ flusspferd::object flusspferd_repl::option_spec() {
 void flusspferd_repl::parse_cmdline() {
   flusspferd::root_object spec(option_spec());
 
-  flusspferd::array arguments(flusspferd::create_array());
+  flusspferd::array_builder builder(argc);
 
   for (int i = 1; i < argc; ++i)
-    arguments.call("push", std::string(argv[i]));
+    builder.push(flusspferd::value(std::string(argv[i])));
+
+  flusspferd::array arguments(builder.finish());
 
   flusspferd::root_object results(flusspferd::getopt(spec, arguments));
 
@@ -567,8 +595,61 @@ bool flusspferd_repl::getline(std::string &source, char const *prompt) {
   }
 }
 
+namespace {
+  std::size_t parse_gc_value(std::string const &value) {
+    // strtoull accepts a sign and wraps negative numbers around.
+    if (value.empty() || !std::isdigit((unsigned char) value[0]))
+      throw flusspferd::exception("Invalid number: " + value);
+    char *end;
+    errno = 0;
+    unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+    if (*end)
+      throw flusspferd::exception("Invalid number: " + value);
+    if (errno == ERANGE || n > std::numeric_limits<std::size_t>::max())
+      throw flusspferd::exception("Number too large: " + value);
+    return std::size_t(n);
+  }
+
+  // The heap limits have to be known when the runtime is created, which is
+  // before the command line is parsed with getopt, so the --gc-* options
+  // (as --name=value or --name value) are picked out of argv here.
+  void configure_gc(int argc, char **argv) {
+    flusspferd::gc_config config;
+
+    for (int i = 1; i < argc; ++i) {
+      std::string arg(argv[i]);
+      if (arg == "--")
+        break;
+      if (arg.compare(0, 5, "--gc-") != 0)
+        continue;
+
+      std::string::size_type eq = arg.find('=');
+      std::string name = arg.substr(2, eq == std::string::npos ? eq : eq - 2);
+      std::string value;
+      if (eq != std::string::npos)
+        value = arg.substr(eq + 1);
+      else if (i + 1 < argc)
+        value = argv[++i];
+
+      if (name == "gc-max-bytes") {
+        config.max_bytes = parse_gc_value(value);
+      } else if (name == "gc-max-malloc-bytes") {
+        config.max_malloc_bytes = parse_gc_value(value);
+      } else if (name == "gc-trigger-factor") {
+        std::size_t n = parse_gc_value(value);
+        if (n > std::numeric_limits<unsigned>::max())
+          throw flusspferd::exception("Number too large: " + value);
+        config.trigger_factor = unsigned(n);
+      }
+    }
+
+    flusspferd::init::configure(config);
+  }
+}
+
 int main(int argc, char **argv) {
   try {
+    configure_gc(argc, argv);
     flusspferd::init::initialize();
     flusspferd_repl repl(argc, argv);
     return repl.run();
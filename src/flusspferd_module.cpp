@@ -27,15 +27,24 @@ THE SOFTWARE.
 #include "flusspferd/version.hpp"
 #include "flusspferd/load_core.hpp"
 #include "flusspferd/create.hpp"
+#include "flusspferd/init.hpp"
+#include "flusspferd/heap_census.hpp"
+#include "flusspferd/exception.hpp"
 #include "flusspferd/io/filesystem-base.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
+#include <limits>
+#include <sstream>
 #include <vector>
 #include <stdlib.h>
 
 using boost::optional;
 static optional<std::string> get_exe_name();
 static std::string get_exe_name_from_argv(std::string const &argv0);
+static void set_gc_parameter_by_name(std::string const &name, double value);
+static flusspferd::object get_gc_stats();
+static flusspferd::object get_heap_census();
+static std::string dump_heap_census();
 
 using namespace flusspferd;
 namespace fs = boost::filesystem;
@@ -67,6 +76,11 @@ void flusspferd::load_flusspferd_module(object container, std::string const &arg
     value(INSTALL_PREFIX),
     read_only_property | permanent_property);
 
+  create_native_function(exports, "setGCParameter", &set_gc_parameter_by_name);
+  create_native_function(exports, "gcStats", &get_gc_stats);
+  create_native_function(exports, "heapCensus", &get_heap_census);
+  create_native_function(exports, "heapCensusDump", &dump_heap_census);
+
   optional<std::string> exe = get_exe_name();
 
   if (exe) {
@@ -96,6 +110,92 @@ std::string flusspferd::version() {
   return FLUSSPFERD_VERSION;
 }
 
+// setGCParameter(name, value): retune the garbage collector at runtime. name
+// is one of "maxBytes", "maxMallocBytes" or "triggerFactor".
+void set_gc_parameter_by_name(std::string const &name, double value) {
+  gc_parameter key;
+  if (name == "maxBytes")
+    key = gc_max_bytes;
+  else if (name == "maxMallocBytes")
+    key = gc_max_malloc_bytes;
+  else if (name == "triggerFactor")
+    key = gc_trigger_factor;
+  else
+    throw exception("Unknown GC parameter: " + name);
+
+  if (!(value >= 0))
+    throw exception("GC parameter must not be negative");
+  if (value >= double(std::numeric_limits<std::size_t>::max()))
+    throw exception("GC parameter too large");
+
+  flusspferd::set_gc_parameter(key, std::size_t(value));
+}
+
+// gcStats(): a snapshot of the garbage collection statistics. Times are in
+// milliseconds; pauseHistogram[i] counts pauses shorter than 2^i ms.
+flusspferd::object get_gc_stats() {
+  gc_stats stats = current_context().gc_stats();
+
+  object result = create_object();
+  root_object root_result(result);
+
+  result.set_property("collections", value(double(stats.collections)));
+  result.set_property(
+    "explicitCollections", value(double(stats.explicit_collections)));
+  result.set_property(
+    "totalPause", value(stats.total_pause_us / 1000.0));
+  result.set_property("maxPause", value(stats.max_pause_us / 1000.0));
+  result.set_property("lastPause", value(stats.last_pause_us / 1000.0));
+  result.set_property(
+    "lastBytesBefore", value(double(stats.last_bytes_before)));
+  result.set_property(
+    "lastBytesAfter", value(double(stats.last_bytes_after)));
+  result.set_property(
+    "totalBytesReclaimed", value(double(stats.total_bytes_reclaimed)));
+  result.set_property(
+    "lastReason",
+    value(stats.last_reason == gc_reason_explicit ? "explicit" : "automatic"));
+
+  array_builder histogram(gc_stats::pause_buckets);
+  for (std::size_t i = 0; i < gc_stats::pause_buckets; ++i)
+    histogram.push(value(double(stats.pause_histogram[i])));
+  result.set_property("pauseHistogram", histogram.finish());
+
+  return result;
+}
+
+// heapCensus(): the live GC things grouped by class, as
+// { classes: { name: { count, externalBytes } }, count, externalBytes }.
+flusspferd::object get_heap_census() {
+  heap_census census = take_heap_census();
+
+  object result = create_object();
+  root_object root_result(result);
+
+  object classes = create_object();
+  result.set_property("classes", classes);
+
+  for (heap_census_entry const &entry : census.entries) {
+    object item = create_object();
+    classes.set_property(entry.name, item);
+    item.set_property("count", value(double(entry.count)));
+    item.set_property("externalBytes", value(double(entry.external_bytes)));
+  }
+
+  result.set_property("count", value(double(census.total_count)));
+  result.set_property(
+    "externalBytes", value(double(census.total_external_bytes)));
+
+  return result;
+}
+
+// heapCensusDump(): the census as text, see heap_census::dump.
+std::string dump_heap_census() {
+  std::ostringstream out;
+  take_heap_census().dump(out);
+  return out.str();
+}
+
 // The fallback mechanism if platform specific method doesn't exist or failed
 // 1. see if the file exists - if so canonicalize it
 // 2. failing that, search in the path for binary named argv0
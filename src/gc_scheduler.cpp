@@ -0,0 +1,129 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/gc_scheduler.hpp"
+#include "flusspferd/native_object_base.hpp"
+#include "flusspferd/init.hpp"
+#include "flusspferd/spidermonkey/context.hpp"
+#include <js/jsapi.h>
+
+using namespace flusspferd;
+
+namespace chrono = std::chrono;
+
+gc_scheduler::gc_scheduler(context const &c, config const &cfg)
+  : ctx(c), cfg(cfg), seen_collections(0)
+{
+  collected(chrono::steady_clock::now());
+  last_tick = last_gc;
+}
+
+gc_scheduler::action gc_scheduler::tick(chrono::microseconds budget) {
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+  // The engine may have collected by itself since the last tick.
+  gc_stats stats = ctx.gc_stats();
+  if (stats.collections != seen_collections)
+    collected(now);
+
+  // Expect a pause like the longer of the last one and the average.
+  unsigned long long expected_us = stats.last_pause_us;
+  if (stats.collections) {
+    unsigned long long average_us = stats.total_pause_us / stats.collections;
+    if (average_us > expected_us)
+      expected_us = average_us;
+  }
+
+  action result = skipped;
+
+  // An overdue collection runs even if it does not fit the budget. Otherwise
+  // one long pause, which keeps the expected pause above a short budget,
+  // would stop the scheduler from ever collecting again.
+  bool overdue = now - last_gc >= cfg.max_interval;
+
+  if (overdue) {
+    ctx.gc();
+    result = full_gc;
+    collected(chrono::steady_clock::now());
+  } else if (budget.count() > 0 &&
+             expected_us <= (unsigned long long) budget.count())
+  {
+    if (want_full(now)) {
+      ctx.gc();
+      result = full_gc;
+    } else {
+      JS_MaybeGC(Impl::get_context(ctx));
+      result = maybe_gc;
+    }
+    if (ctx.gc_stats().collections != seen_collections)
+      collected(chrono::steady_clock::now());
+  }
+
+  // Spend what is left of the budget on deferred finalizers.
+  chrono::steady_clock::time_point deadline = now + budget;
+  while (native_object_base::pending_finalizers() &&
+         chrono::steady_clock::now() < deadline)
+    native_object_base::drain_finalizers(16);
+
+  last_tick = now;
+  return result;
+}
+
+bool gc_scheduler::want_full(chrono::steady_clock::time_point now) {
+  std::size_t external = ctx.external_bytes();
+  if (external > external_after &&
+      external - external_after >= cfg.external_growth)
+    return true;
+
+  std::size_t heap = init::initialize().heap_bytes();
+  std::size_t growth = heap > heap_after ? heap - heap_after : 0;
+  std::size_t threshold = heap_after / 100 * cfg.heap_growth_percent;
+  if (threshold < cfg.min_heap_growth)
+    threshold = cfg.min_heap_growth;
+
+  if (growth >= threshold)
+    return true;
+
+  // Collect in this idle gap if the heap is going to cross the threshold
+  // before the next tick at the current allocation rate.
+  double elapsed = chrono::duration<double>(now - last_gc).count();
+  double interval = chrono::duration<double>(now - last_tick).count();
+  if (elapsed > 0) {
+    double rate = growth / elapsed;
+    if (growth + rate * interval >= threshold)
+      return true;
+  }
+
+  return false;
+}
+
+void gc_scheduler::collected(chrono::steady_clock::time_point now) {
+  seen_collections = ctx.gc_stats().collections;
+  last_gc = now;
+  heap_after = init::initialize().heap_bytes();
+  external_after = ctx.external_bytes();
+}
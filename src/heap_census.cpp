@@ -0,0 +1,148 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/heap_census.hpp"
+#include "flusspferd/native_object_base.hpp"
+#include "flusspferd/exception.hpp"
+#include "flusspferd/init.hpp"
+#include "flusspferd/spidermonkey/context.hpp"
+#include "flusspferd/spidermonkey/object.hpp"
+#include <js/jsapi.h>
+#include <map>
+#include <ostream>
+#include <unordered_set>
+#include <utility>
+
+using namespace flusspferd;
+
+#if JS_VERSION >= 180
+namespace {
+  // The census visits every thing once. JS_TraceRuntime and JS_TraceChildren
+  // report the edges to the callback, which queues the things not seen yet;
+  // an explicit stack keeps deep object graphs from overflowing the C++ one.
+  struct census_tracer : JSTracer {
+    std::unordered_set<void *> seen;
+    std::vector<std::pair<void *, uint32> > pending;
+  };
+
+  void census_callback(JSTracer *trc, void *thing, uint32 kind) {
+    census_tracer *self = static_cast<census_tracer *>(trc);
+    if (self->seen.insert(thing).second)
+      self->pending.push_back(std::make_pair(thing, kind));
+  }
+
+  struct census_counter {
+    std::size_t count;
+    std::size_t external_bytes;
+  };
+
+  void classify(
+    JSContext *cx, void *thing, uint32 kind,
+    std::map<std::string, census_counter> &counters)
+  {
+    char const *name;
+    std::size_t external = 0;
+
+    switch (kind) {
+    case JSTRACE_OBJECT:
+      {
+        JSObject *obj = static_cast<JSObject *>(thing);
+        JSClass *classp = JS_GET_CLASS(cx, obj);
+        name = classp && classp->name ? classp->name : "Object";
+
+        native_object_base *self =
+          native_object_base::try_get_native(Impl::wrap_object(obj));
+        if (self) {
+          detail::class_tag const *tag = self->native_class_tag();
+          if (tag && tag->name)
+            name = tag->name;
+          external = self->external_size();
+        }
+      }
+      break;
+    case JSTRACE_STRING:
+      name = "string";
+      external =
+        JS_GetStringLength(static_cast<JSString *>(thing)) * sizeof(jschar);
+      break;
+    case JSTRACE_DOUBLE:
+      name = "double";
+      break;
+    default:
+      name = "xml";
+      break;
+    }
+
+    census_counter &counter = counters[name];
+    ++counter.count;
+    counter.external_bytes += external;
+  }
+}
+#endif
+
+heap_census flusspferd::take_heap_census() {
+  heap_census result;
+  result.total_count = 0;
+  result.total_external_bytes = 0;
+
+#if JS_VERSION >= 180
+  JSContext *cx = Impl::get_context(current_context());
+
+  census_tracer trc;
+  JS_TRACER_INIT(&trc, cx, &census_callback);
+  JS_TraceRuntime(&trc);
+
+  std::map<std::string, census_counter> counters;
+  while (!trc.pending.empty()) {
+    std::pair<void *, uint32> thing = trc.pending.back();
+    trc.pending.pop_back();
+    classify(cx, thing.first, thing.second, counters);
+    JS_TraceChildren(&trc, thing.first, thing.second);
+  }
+
+  result.entries.reserve(counters.size());
+  for (auto const &counter : counters) {
+    heap_census_entry entry = {
+      counter.first, counter.second.count, counter.second.external_bytes
+    };
+    result.entries.push_back(entry);
+    result.total_count += entry.count;
+    result.total_external_bytes += entry.external_bytes;
+  }
+#else
+  throw exception("Heap census needs SpiderMonkey 1.8 or newer");
+#endif
+
+  return result;
+}
+
+void heap_census::dump(std::ostream &out) const {
+  for (heap_census_entry const &entry : entries)
+    out << entry.count << '\t' << entry.external_bytes << '\t'
+        << entry.name << '\n';
+  out << total_count << '\t' << total_external_bytes << "\t(total)\n";
+}
@@ -28,11 +28,29 @@ THE SOFTWARE.
 #include "flusspferd/exception.hpp"
 #include "flusspferd/context.hpp"
 #include "flusspferd/object.hpp"
+#include "flusspferd/tracer.hpp"
+#include "flusspferd/native_object_base.hpp"
 #include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/root.hpp"
 #include <boost/thread/tss.hpp>
 #include <boost/thread/once.hpp>
+#include <boost/thread/mutex.hpp>
 #include <js/jsapi.h>
+
+// JSGC_TRIGGER_FACTOR, JSGC_BYTES and JS_GetGCParameter were added in
+// Spidermonkey 1.8.1, which has the same JS_VERSION as 1.8.0. Define
+// FLUSSPFERD_JS_1_8_1 when building against 1.8.1.
+#if JS_VERSION > 180 || defined(FLUSSPFERD_JS_1_8_1)
+#define FLUSSPFERD_HAVE_GC_PARAMETERS
+#endif
+
+#ifndef FLUSSPFERD_HAVE_GC_PARAMETERS
+#include <js/jscntxt.h>
+#endif
 #include <cassert>
+#include <limits>
+#include <atomic>
+#include <chrono>
 
 #ifndef FLUSSPFERD_MAX_BYTES
 #define FLUSSPFERD_MAX_BYTES 8L * 1024L * 1024L // 8 MB TODO: too much?
@@ -42,10 +60,181 @@ using namespace flusspferd;
 
 static boost::thread_specific_ptr<init> p_instance;
 
+// Set by init::configure, read when a thread creates its runtime.
+static boost::mutex gc_config_mutex;
+static gc_config configured_gc;
+
+thread_local constinit Impl::thread_state Impl::current_thread =
+  { 0, 0, 0, 0, false };
+
 #if JS_VERSION >= 180
 static boost::once_flag runtime_created = BOOST_ONCE_INIT;
 #endif
 
+// The number of runtimes created so far, see Impl::runtime_generation.
+static std::atomic<unsigned long> runtime_generations(0);
+
+namespace {
+  // The engine takes 32 bit parameters; larger values are rejected instead
+  // of being silently cut.
+  uint32 gc_parameter_value(std::size_t value) {
+    if (value > std::numeric_limits<uint32>::max())
+      throw exception(
+        "GC parameter too large (the engine's limit is 4294967295)");
+    return uint32(value);
+  }
+
+  void apply_gc_parameter(JSRuntime *rt, gc_parameter key, std::size_t value) {
+    switch (key) {
+    case gc_max_bytes:
+      JS_SetGCParameter(rt, JSGC_MAX_BYTES, gc_parameter_value(value));
+      break;
+    case gc_max_malloc_bytes:
+      JS_SetGCParameter(rt, JSGC_MAX_MALLOC_BYTES, gc_parameter_value(value));
+      break;
+    case gc_trigger_factor:
+#ifdef FLUSSPFERD_HAVE_GC_PARAMETERS
+      JS_SetGCParameter(rt, JSGC_TRIGGER_FACTOR, gc_parameter_value(value));
+      break;
+#else
+      throw exception(
+        "GC trigger factor not supported before Spidermonkey 1.8.1");
+#endif
+    default:
+      throw exception("Unknown GC parameter");
+    }
+  }
+
+  void apply_gc_config(JSRuntime *rt, gc_config const &config) {
+    if (config.max_bytes)
+      apply_gc_parameter(rt, gc_max_bytes, config.max_bytes);
+    if (config.max_malloc_bytes)
+      apply_gc_parameter(rt, gc_max_malloc_bytes, config.max_malloc_bytes);
+    if (config.trigger_factor)
+      apply_gc_parameter(rt, gc_trigger_factor, config.trigger_factor);
+  }
+
+#if JS_VERSION >= 180
+  void trace_extra_roots(JSTracer *trc, void *) {
+    tracer trc_(trc);
+    Impl::extra_roots::trace_all(trc_);
+  }
+#endif
+
+  std::size_t gc_bytes(JSRuntime *rt) {
+#ifdef FLUSSPFERD_HAVE_GC_PARAMETERS
+    return JS_GetGCParameter(rt, JSGC_BYTES);
+#else
+    return rt->gcBytes;
+#endif
+  }
+
+  template<typename T>
+  void atomic_max(std::atomic<T> &x, T v) {
+    T old = x.load(std::memory_order_relaxed);
+    while (old < v &&
+           !x.compare_exchange_weak(old, v, std::memory_order_relaxed))
+      ;
+  }
+
+  // Collects the numbers behind init::gc_stats. Only the GC callback writes
+  // (on the runtime's thread); the counters are atomic so a snapshot can be
+  // taken from anywhere without locking.
+  class gc_recorder {
+  public:
+    gc_recorder() : running(false) {
+      collections = 0;
+      explicit_collections = 0;
+      total_pause_us = 0;
+      max_pause_us = 0;
+      last_pause_us = 0;
+      last_bytes_before = 0;
+      last_bytes_after = 0;
+      total_bytes_reclaimed = 0;
+      last_reason = gc_reason_automatic;
+      for (std::size_t i = 0; i < gc_stats::pause_buckets; ++i)
+        pause_histogram[i] = 0;
+    }
+
+    void begin(JSRuntime *rt) {
+      if (running)
+        return;
+      running = true;
+      reason = Impl::current_thread.explicit_gc
+             ? gc_reason_explicit : gc_reason_automatic;
+      Impl::current_thread.explicit_gc = false;
+      bytes_before = gc_bytes(rt);
+      start = std::chrono::steady_clock::now();
+    }
+
+    void end(JSRuntime *rt) {
+      if (!running)
+        return;
+      running = false;
+
+      unsigned long long pause =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start).count();
+      std::size_t bytes_after = gc_bytes(rt);
+
+      std::memory_order const relaxed = std::memory_order_relaxed;
+      collections.fetch_add(1, relaxed);
+      if (reason == gc_reason_explicit)
+        explicit_collections.fetch_add(1, relaxed);
+      total_pause_us.fetch_add(pause, relaxed);
+      atomic_max(max_pause_us, pause);
+      last_pause_us.store(pause, relaxed);
+      last_bytes_before.store(bytes_before, relaxed);
+      last_bytes_after.store(bytes_after, relaxed);
+      if (bytes_after < bytes_before)
+        total_bytes_reclaimed.fetch_add(bytes_before - bytes_after, relaxed);
+      last_reason.store(reason, relaxed);
+
+      std::size_t bucket = 0;
+      for (unsigned long long ms = pause / 1000; ms; ms >>= 1)
+        ++bucket;
+      if (bucket >= gc_stats::pause_buckets)
+        bucket = gc_stats::pause_buckets - 1;
+      pause_histogram[bucket].fetch_add(1, relaxed);
+    }
+
+    gc_stats snapshot() const {
+      std::memory_order const relaxed = std::memory_order_relaxed;
+      gc_stats result;
+      result.collections = collections.load(relaxed);
+      result.explicit_collections = explicit_collections.load(relaxed);
+      result.total_pause_us = total_pause_us.load(relaxed);
+      result.max_pause_us = max_pause_us.load(relaxed);
+      result.last_pause_us = last_pause_us.load(relaxed);
+      result.last_bytes_before = last_bytes_before.load(relaxed);
+      result.last_bytes_after = last_bytes_after.load(relaxed);
+      result.total_bytes_reclaimed = total_bytes_reclaimed.load(relaxed);
+      result.last_reason = last_reason.load(relaxed);
+      for (std::size_t i = 0; i < gc_stats::pause_buckets; ++i)
+        result.pause_histogram[i] = pause_histogram[i].load(relaxed);
+      return result;
+    }
+
+  private:
+    std::atomic<unsigned long> collections;
+    std::atomic<unsigned long> explicit_collections;
+    std::atomic<unsigned long long> total_pause_us;
+    std::atomic<unsigned long long> max_pause_us;
+    std::atomic<unsigned long long> last_pause_us;
+    std::atomic<std::size_t> last_bytes_before;
+    std::atomic<std::size_t> last_bytes_after;
+    std::atomic<unsigned long long> total_bytes_reclaimed;
+    std::atomic<gc_reason> last_reason;
+    std::atomic<unsigned long> pause_histogram[gc_stats::pause_buckets];
+
+    // State of the collection in progress.
+    bool running;
+    gc_reason reason;
+    std::size_t bytes_before;
+    std::chrono::steady_clock::time_point start;
+  };
+}
+
 class init::impl {
 public:
   // we use a single JS_Runtime for each process!
@@ -58,17 +247,42 @@ public:
     if (!JS_CStringsAreUTF8())
       throw std::runtime_error("UTF8 support in Spidermonkey required");
 
-    runtime = JS_NewRuntime( FLUSSPFERD_MAX_BYTES );
+    gc_config config;
+    {
+      boost::mutex::scoped_lock lock(gc_config_mutex);
+      config = configured_gc;
+    }
+
+    runtime = JS_NewRuntime(
+      config.max_bytes
+        ? gc_parameter_value(config.max_bytes)
+        : FLUSSPFERD_MAX_BYTES);
     if (!runtime) {
       throw std::runtime_error("Could not create Spidermonkey Runtime");
     }
+
+    generation = ++runtime_generations;
+
+    try {
+      apply_gc_config(runtime, config);
+    } catch (...) {
+      JS_DestroyRuntime(runtime);
+      throw;
+    }
+
+#if JS_VERSION >= 180
+    JS_SetExtraGCRoots(runtime, &trace_extra_roots, 0);
+#endif
   }
   ~impl() {
     JS_DestroyRuntime(runtime);
+    native_object_base::drain_finalizers();
   }
 
   JSRuntime *runtime;
+  unsigned long generation;
   context current_context;
+  gc_recorder gc;
 
 };
 
@@ -76,30 +290,92 @@ struct init::detail {
   static JSRuntime *get(init &in) {
     return in.p->runtime;
   }
+
+  static unsigned long generation(init &in) {
+    return in.p->generation;
+  }
+
+  static JSBool gc_callback(JSContext *cx, JSGCStatus status) {
+#if JS_VERSION < 180
+    if (status == JSGC_MARK_END) {
+      tracer trc_(0);
+      Impl::extra_roots::trace_all(trc_);
+    }
+#endif
+
+    init *instance = Impl::current_thread.instance;
+    if (!instance)
+      return JS_TRUE;
+
+    if (status == JSGC_BEGIN)
+      instance->p->gc.begin(JS_GetRuntime(cx));
+    else if (status == JSGC_END)
+      instance->p->gc.end(JS_GetRuntime(cx));
+
+    return JS_TRUE;
+  }
 };
 
-JSRuntime *Impl::get_runtime() {
+unsigned long Impl::runtime_generation() {
+  return init::detail::generation(init::initialize());
+}
+
+JSRuntime *Impl::load_runtime() {
   return init::detail::get(init::initialize());
 }
 
 init &init::initialize() {
+  if (init *instance = Impl::current_thread.instance)
+    return *instance;
   if (!p_instance.get())
     p_instance.reset(new init);
+  Impl::current_thread.instance = p_instance.get();
+  Impl::current_thread.runtime = p_instance->p->runtime;
   return *p_instance;
 }
 
-init::init() : p(new impl) { }
-init::~init() {}
+void init::configure(gc_config const &config) {
+  {
+    boost::mutex::scoped_lock lock(gc_config_mutex);
+    configured_gc = config;
+  }
+  if (init *instance = Impl::current_thread.instance)
+    apply_gc_config(instance->p->runtime, config);
+}
+
+void init::set_gc_parameter(gc_parameter key, std::size_t value) {
+  apply_gc_parameter(p->runtime, key, value);
+}
+
+gc_stats init::gc_stats() const {
+  return p->gc.snapshot();
+}
+
+std::size_t init::heap_bytes() const {
+  return gc_bytes(p->runtime);
+}
+
+init::init() : p(new impl) {
+  JS_SetGCCallbackRT(p->runtime, &detail::gc_callback);
+}
+init::~init() {
+  Impl::current_thread.instance = 0;
+  Impl::current_thread.context = 0;
+  Impl::current_thread.runtime = 0;
+}
 
 context init::enter_current_context(context const &c) {
   context old = p->current_context;
   p->current_context = c;
+  Impl::current_thread.context =
+    c.is_valid() ? Impl::get_context(p->current_context) : 0;
   return old;
 }
 
 bool init::leave_current_context(context const &c) {
   if (c == p->current_context) {
     p->current_context = context();
+    Impl::current_thread.context = 0;
     return true;
   } else {
     return !p->current_context.is_valid();
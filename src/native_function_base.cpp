@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "flusspferd/spidermonkey/init.hpp"
 #include "flusspferd/spidermonkey/context.hpp"
 #include "flusspferd/spidermonkey/function.hpp"
+#include "flusspferd/spidermonkey/function_spec.hpp"
 #include "flusspferd/current_context_scope.hpp"
 #include <js/jsapi.h>
 
@@ -139,7 +140,7 @@ JSBool native_function_base::impl::call_helper(
     JSContext *ctx, JSObject *obj, uintN argc, jsval *argv, jsval *rval)
 {
   FLUSSPFERD_CALLBACK_BEGIN {
-    current_context_scope scope(Impl::wrap_context(ctx));
+    Impl::callback_context_scope scope(ctx);
 
     JSObject *function = JSVAL_TO_OBJECT(argv[-2]);
 
@@ -170,7 +171,7 @@ JSBool native_function_base::impl::call_helper(
 void native_function_base::impl::trace_op(
     JSTracer *trc, JSObject *obj)
 {
-  current_context_scope scope(Impl::wrap_context(trc->context));
+  Impl::callback_context_scope scope(trc->context);
 
   native_function_base *self =
     native_function_base::get_native(Impl::wrap_object(obj));
@@ -182,7 +183,7 @@ void native_function_base::impl::trace_op(
 uint32 native_function_base::impl::mark_op(
     JSContext *ctx, JSObject *obj, void *thing)
 {
-  current_context_scope scope(Impl::wrap_context(ctx));
+  Impl::callback_context_scope scope(ctx);
 
   native_function_base *self =
     native_function_base::get_native(Impl::wrap_object(obj));
@@ -195,7 +196,7 @@ uint32 native_function_base::impl::mark_op(
 #endif
 
 void native_function_base::impl::finalize(JSContext *ctx, JSObject *priv) {
-  current_context_scope scope(Impl::wrap_context(ctx));
+  Impl::callback_context_scope scope(ctx);
 
   native_function_base *self =
     (native_function_base *) JS_GetInstancePrivate(ctx, priv, &function_priv_class, 0);
@@ -223,7 +224,7 @@ native_function_base *native_function_base::get_native(object const &o_) {
 
   jsval p_val;
 
-  if (!JS_GetReservedSlot(ctx, p, 0, &p_val))
+  if (!JS_GetReservedSlot(ctx, p, 0, &p_val) || !JSVAL_IS_OBJECT(p_val))
     throw exception("Could not get native function pointer");
 
   p = JSVAL_TO_OBJECT(p_val);
@@ -241,3 +242,52 @@ native_function_base *native_function_base::get_native(object const &o_) {
 }
 
 void native_function_base::trace(tracer&) {}
+
+JSBool Impl::call_native_thunk(
+  JSContext *ctx, JSObject *obj, uintN argc, jsval *argv, jsval *rval,
+  native_thunk thunk)
+{
+  FLUSSPFERD_CALLBACK_BEGIN {
+    Impl::callback_context_scope scope(ctx);
+
+    call_context x;
+
+    x.self = Impl::wrap_object(obj);
+    x.arg = Impl::arguments_impl(argc, argv);
+    x.result.bind(Impl::wrap_jsvalp(rval));
+    x.function = Impl::wrap_object(JSVAL_TO_OBJECT(argv[-2]));
+
+    thunk(x);
+  } FLUSSPFERD_CALLBACK_END;
+}
+
+JSBool Impl::call_property_thunk(
+  JSContext *ctx, JSObject *obj, jsval *vp, bool set, native_thunk thunk)
+{
+  FLUSSPFERD_CALLBACK_BEGIN {
+    Impl::callback_context_scope scope(ctx);
+
+    call_context x;
+
+    x.self = Impl::wrap_object(obj);
+    if (set)
+      x.arg = Impl::arguments_impl(1, vp);
+    // Setters may replace the assigned value, just like a setter function's
+    // return value does.
+    x.result.bind(Impl::wrap_jsvalp(vp));
+
+    thunk(x);
+  } FLUSSPFERD_CALLBACK_END;
+}
+
+void Impl::define_functions(object const &obj, function_spec *specs) {
+  if (!JS_DefineFunctions(
+        Impl::current_context(), Impl::get_object(obj), specs))
+    throw exception("Could not define methods");
+}
+
+void Impl::define_properties(object const &obj, property_spec *specs) {
+  if (!JS_DefineProperties(
+        Impl::current_context(), Impl::get_object(obj), specs))
+    throw exception("Could not define properties");
+}
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "flusspferd/spidermonkey/init.hpp"
 #include <unordered_map>
 #include <boost/variant.hpp>
+#include <boost/thread/mutex.hpp>
+#include <vector>
 
 using namespace flusspferd;
 
@@ -119,14 +121,11 @@ JSClass native_object_base::impl::native_enumerable_object_class = {
   0
 };
 
-native_object_base::native_object_base(object const &o) {
-  p = new boost::scoped_ptr<impl>(new impl);
+native_object_base::native_object_base(object const &o) : tag(0) {
   load_into(o);
 }
 
 native_object_base::~native_object_base() {
-  if(p)
-  	delete p;
   if (!is_null()) {
     JS_SetPrivate(Impl::current_context(), get(), 0);
   }
@@ -144,44 +143,36 @@ void native_object_base::load_into(object const &o) {
   }
 }
 
-bool native_object_base::is_object_native(object const &o_) {
+bool native_object_base::is_object_native(object const &o) {
+  return try_get_native(o);
+}
+
+native_object_base *native_object_base::try_get_native(object const &o_) {
   object o = o_;
 
   if (o.is_null())
-    return false;
+    return 0;
 
   JSContext *ctx = Impl::current_context();
   JSObject *jso = Impl::get_object(o);
   JSClass *classp = JS_GET_CLASS(ctx, jso);
 
   if (!classp || classp->finalize != &native_object_base::impl::finalize)
-    return false;
+    return 0;
 
-  void *priv = JS_GetPrivate(ctx, jso);
-  if (!priv)
-    return false;
-
-  return true;
+  return static_cast<native_object_base*>(JS_GetPrivate(ctx, jso));
 }
 
-native_object_base &native_object_base::get_native(object const &o_) {
-  object o = o_;
-
+native_object_base &native_object_base::get_native(object const &o) {
   if (o.is_null())
     throw exception("Can not interpret 'null' as native object");
 
-  JSContext *ctx = Impl::current_context();
-  JSObject *jso = Impl::get_object(o);
-  JSClass *classp = JS_GET_CLASS(ctx, jso);
+  native_object_base *self = try_get_native(o);
 
-  if (!classp || classp->finalize != &native_object_base::impl::finalize)
-    throw exception("Object is not native");
-
-  void *priv = JS_GetPrivate(ctx, jso);
-  if (!priv)
+  if (!self)
     throw exception("Object is not native");
 
-  return *static_cast<native_object_base*>(priv);
+  return *self;
 }
 
 object native_object_base::do_create_object(object const &prototype_) {
@@ -218,30 +209,70 @@ object native_object_base::do_create_enumerable_object(object const &prototype_)
   return Impl::wrap_object(o);
 }
 
+namespace {
+  // Objects waiting for native_object_base::drain_finalizers. Shared between
+  // threads so that a background thread can drain it.
+  boost::mutex deferred_mutex;
+  std::vector<native_object_base*> deferred;
+}
+
 void native_object_base::impl::finalize(JSContext *ctx, JSObject *obj) {
   void *p = JS_GetPrivate(ctx, obj);
 
   if (p) {
-    current_context_scope scope(Impl::wrap_context(ctx));
-    delete static_cast<native_object_base*>(p);
+    native_object_base *self = static_cast<native_object_base*>(p);
+
+    detail::class_tag const *tag = self->native_class_tag();
+    if (tag && tag->deferred_finalize) {
+      // Detach from the dying object; the destructor must not touch it.
+      JS_SetPrivate(ctx, obj, 0);
+      self->object::operator=(object());
+
+      boost::mutex::scoped_lock lock(deferred_mutex);
+      deferred.push_back(self);
+      return;
+    }
+
+    Impl::callback_context_scope scope(ctx);
+    delete self;
   }
 }
 
+std::size_t native_object_base::drain_finalizers(std::size_t max) {
+  std::size_t n = 0;
+  while (n < max) {
+    native_object_base *self;
+    {
+      boost::mutex::scoped_lock lock(deferred_mutex);
+      if (deferred.empty())
+        break;
+      self = deferred.back();
+      deferred.pop_back();
+    }
+    delete self;
+    ++n;
+  }
+  return n;
+}
+
+std::size_t native_object_base::pending_finalizers() {
+  boost::mutex::scoped_lock lock(deferred_mutex);
+  return deferred.size();
+}
+
 JSBool native_object_base::impl::call_helper(
     JSContext *ctx, JSObject *obj, uintN argc, jsval *argv, jsval *rval)
 {
   FLUSSPFERD_CALLBACK_BEGIN {
-    current_context_scope scope(Impl::wrap_context(ctx));
+    Impl::callback_context_scope scope(ctx);
 
     JSObject *function = JSVAL_TO_OBJECT(argv[-2]);
 
-    native_object_base *self = 0;
-    
-    try {
-      self = &native_object_base::get_native(Impl::wrap_object(obj));
-    } catch (exception &) {
+    native_object_base *self =
+      native_object_base::try_get_native(Impl::wrap_object(obj));
+
+    if (!self)
       self = &native_object_base::get_native(Impl::wrap_object(function));
-    }
 
     call_context x;
 
@@ -260,7 +291,7 @@ JSBool native_object_base::impl::property_op(
     JSContext *ctx, JSObject *obj, jsval id, jsval *vp)
 {
   FLUSSPFERD_CALLBACK_BEGIN {
-    current_context_scope scope(Impl::wrap_context(ctx));
+    Impl::callback_context_scope scope(ctx);
 
     native_object_base &self =
       native_object_base::get_native(Impl::wrap_object(obj));
@@ -274,7 +305,7 @@ JSBool native_object_base::impl::new_resolve(
     JSContext *ctx, JSObject *obj, jsval id, uintN sm_flags, JSObject **objp)
 {
   FLUSSPFERD_CALLBACK_BEGIN {
-    current_context_scope scope(Impl::wrap_context(ctx));
+    Impl::callback_context_scope scope(ctx);
 
     native_object_base &self =
       native_object_base::get_native(Impl::wrap_object(obj));
@@ -302,7 +333,7 @@ JSBool native_object_base::impl::new_enumerate(
     JSContext *ctx, JSObject *obj, JSIterateOp enum_op, jsval *statep, jsid *idp)
 {
   FLUSSPFERD_CALLBACK_BEGIN {
-    current_context_scope scope(Impl::wrap_context(ctx));
+    Impl::callback_context_scope scope(ctx);
 
     native_object_base &self =
       native_object_base::get_native(Impl::wrap_object(obj));
@@ -345,7 +376,7 @@ JSBool native_object_base::impl::new_enumerate(
 void native_object_base::impl::trace_op(
     JSTracer *trc, JSObject *obj)
 {
-  current_context_scope scope(Impl::wrap_context(trc->context));
+  Impl::callback_context_scope scope(trc->context);
 
   native_object_base &self =
     native_object_base::get_native(Impl::wrap_object(obj));
@@ -357,7 +388,7 @@ void native_object_base::impl::trace_op(
 uint32 native_object_base::impl::mark_op(
     JSContext *ctx, JSObject *obj, void *thing)
 {
-  current_context_scope scope(Impl::wrap_context(ctx));
+  Impl::callback_context_scope scope(ctx);
 
   native_object_base &self =
     native_object_base::get_native(Impl::wrap_object(obj));
@@ -393,3 +424,7 @@ void native_object_base::self_call(call_context &) {
 }
 
 void native_object_base::trace(tracer&) {}
+
+std::size_t native_object_base::external_size() const {
+  return 0;
+}
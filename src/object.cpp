@@ -45,6 +45,88 @@ THE SOFTWARE.
 
 using namespace flusspferd;
 
+namespace {
+  // Spidermonkey copies the arguments onto its own stack and never writes
+  // through argv, so the caller's pack is passed as is instead of a copy.
+  jsval *argv(arguments const &arg) {
+    return const_cast<jsval*>(Impl::get_arguments(arg));
+  }
+
+  // Property access by ID. Integer IDs take the element fast path; anything
+  // else goes through the object's property ops without being converted to
+  // a string first.
+
+  JSBool get_by_id(JSContext *cx, JSObject *obj, jsid id, jsval *vp) {
+#if JS_VERSION >= 180
+    return JS_GetPropertyById(cx, obj, id, vp);
+#else
+    return OBJ_GET_PROPERTY(cx, obj, id, vp);
+#endif
+  }
+
+  JSBool set_by_id(JSContext *cx, JSObject *obj, jsid id, jsval *vp) {
+#if JS_VERSION >= 180
+    return JS_SetPropertyById(cx, obj, id, vp);
+#else
+    return OBJ_SET_PROPERTY(cx, obj, id, vp);
+#endif
+  }
+
+  JSBool has_by_id(JSContext *cx, JSObject *obj, jsid id, JSBool *foundp) {
+#if JS_VERSION >= 180
+    return JS_HasPropertyById(cx, obj, id, foundp);
+#else
+    JSObject *obj2;
+    JSProperty *prop;
+    if (!OBJ_LOOKUP_PROPERTY(cx, obj, id, &obj2, &prop))
+      return JS_FALSE;
+    *foundp = prop != 0;
+    if (prop)
+      OBJ_DROP_PROPERTY(cx, obj2, prop);
+    return JS_TRUE;
+#endif
+  }
+
+  JSBool delete_by_id(JSContext *cx, JSObject *obj, jsid id) {
+#if JS_VERSION >= 180
+    return JS_DeletePropertyById(cx, obj, id);
+#else
+    jsval dummy;
+    return OBJ_DELETE_PROPERTY(cx, obj, id, &dummy);
+#endif
+  }
+
+  JSBool get_by_key(
+    JSContext *cx, JSObject *obj, property_key const &key, jsval *vp)
+  {
+    if (Impl::is_index_key(key))
+      return JS_GetElement(cx, obj, Impl::get_index(key), vp);
+    return get_by_id(cx, obj, Impl::get_jsid(key), vp);
+  }
+
+  JSBool set_by_key(
+    JSContext *cx, JSObject *obj, property_key const &key, jsval *vp)
+  {
+    if (Impl::is_index_key(key))
+      return JS_SetElement(cx, obj, Impl::get_index(key), vp);
+    return set_by_id(cx, obj, Impl::get_jsid(key), vp);
+  }
+
+  JSBool get_by_value(JSContext *cx, JSObject *obj, jsval idv, jsval *vp) {
+    if (JSVAL_IS_INT(idv))
+      return JS_GetElement(cx, obj, JSVAL_TO_INT(idv), vp);
+    jsid id;
+    return JS_ValueToId(cx, idv, &id) && get_by_id(cx, obj, id, vp);
+  }
+
+  JSBool set_by_value(JSContext *cx, JSObject *obj, jsval idv, jsval *vp) {
+    if (JSVAL_IS_INT(idv))
+      return JS_SetElement(cx, obj, JSVAL_TO_INT(idv), vp);
+    jsid id;
+    return JS_ValueToId(cx, idv, &id) && set_by_id(cx, obj, id, vp);
+  }
+}
+
 object::object() : Impl::object_impl(0) { }
 object::~object() { }
 
@@ -98,12 +180,18 @@ value object::set_property(std::string const &name, value const &v) {
 value object::set_property(value const &id, value const &v_) {
   if (is_null())
     throw exception("Could not set property (object is null)");
-  local_root_scope scope;
   value v = v_;
-  string name = id.to_string();
-  if (!JS_SetUCProperty(Impl::current_context(), get(),
-                        (jschar*)name.data(), name.length(),
-                        Impl::get_jsvalp(v)))
+  if (!set_by_value(Impl::current_context(), get(), Impl::get_jsval(id),
+                    Impl::get_jsvalp(v)))
+    throw exception("Could not set property");
+  return v;
+}
+
+value object::set_property(property_key const &key, value const &v_) {
+  if (is_null())
+    throw exception("Could not set property (object is null)");
+  value v = v_;
+  if (!set_by_key(Impl::current_context(), get(), key, Impl::get_jsvalp(v)))
     throw exception("Could not set property");
   return v;
 }
@@ -126,11 +214,18 @@ value object::get_property(value const &id) const {
   if (is_null())
     throw exception("Could not get property (object is null)");
   value result;
-  local_root_scope scope;
-  string name = id.to_string();
-  if (!JS_GetUCProperty(Impl::current_context(), get_const(),
-                        (jschar*)name.data(), name.length(),
-                        Impl::get_jsvalp(result)))
+  if (!get_by_value(Impl::current_context(), get_const(),
+                    Impl::get_jsval(id), Impl::get_jsvalp(result)))
+    throw exception("Could not get property");
+  return result;
+}
+
+value object::get_property(property_key const &key) const {
+  if (is_null())
+    throw exception("Could not get property (object is null)");
+  value result;
+  if (!get_by_key(Impl::current_context(), get_const(), key,
+                  Impl::get_jsvalp(result)))
     throw exception("Could not get property");
   return result;
 }
@@ -152,16 +247,76 @@ bool object::has_property(std::string const &name) const {
 bool object::has_property(value const &id) const {
   if (is_null())
     throw exception("Could not check property (object is null)");
-  local_root_scope scope;
-  string name = id.to_string();
+  JSContext *cx = Impl::current_context();
+  jsid jid;
+  JSBool foundp;
+  if (!JS_ValueToId(cx, Impl::get_jsval(id), &jid) ||
+      !has_by_id(cx, get_const(), jid, &foundp))
+    throw exception("Could not check property");
+  return foundp;
+}
+
+bool object::has_property(property_key const &key) const {
+  if (is_null())
+    throw exception("Could not check property (object is null)");
   JSBool foundp;
-  if (!JS_HasUCProperty(Impl::current_context(), get_const(),
-                        (jschar*)name.data(), name.length(),
-                        &foundp))
+  if (!has_by_id(Impl::current_context(), get_const(), Impl::get_jsid(key),
+                 &foundp))
     throw exception("Could not check property");
   return foundp;
 }
 
+std::vector<std::size_t> object::get_properties(
+  std::vector<property_key> const &keys,
+  std::vector<value> &values) const
+{
+  if (is_null())
+    throw exception("Could not get properties (object is null)");
+
+  JSContext *cx = Impl::current_context();
+  JSObject *obj = get_const();
+  std::vector<std::size_t> failed;
+
+  values.resize(keys.size());
+
+  local_root_scope scope;
+
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    jsval v = JSVAL_VOID;
+    if (!get_by_key(cx, obj, keys[i], &v)) {
+      JS_ClearPendingException(cx);
+      v = JSVAL_VOID;
+      failed.push_back(i);
+    }
+    values[i] = Impl::wrap_jsval(v);
+  }
+
+  return failed;
+}
+
+std::vector<std::size_t> object::set_properties(
+  std::vector<std::pair<property_key, value> > const &properties)
+{
+  if (is_null())
+    throw exception("Could not set properties (object is null)");
+
+  JSContext *cx = Impl::current_context();
+  JSObject *obj = get();
+  std::vector<std::size_t> failed;
+
+  local_root_scope scope;
+
+  for (std::size_t i = 0; i < properties.size(); ++i) {
+    jsval v = Impl::get_jsval(properties[i].second);
+    if (!set_by_key(cx, obj, properties[i].first, &v)) {
+      JS_ClearPendingException(cx);
+      failed.push_back(i);
+    }
+  }
+
+  return failed;
+}
+
 bool object::has_own_property(char const *name_) const {
   local_root_scope scope;
   string name(name_);
@@ -213,11 +368,17 @@ void object::delete_property(std::string const &name) {
 void object::delete_property(value const &id) {
   if (is_null())
     throw exception("Could not delete property (object is null)");
-  local_root_scope scope;
-  string name = id.to_string();
-  jsval dummy;
-  if (!JS_DeleteUCProperty2(Impl::current_context(), get(),
-                            (jschar*)name.data(), name.length(), &dummy))
+  JSContext *cx = Impl::current_context();
+  jsid jid;
+  if (!JS_ValueToId(cx, Impl::get_jsval(id), &jid) ||
+      !delete_by_id(cx, get(), jid))
+    throw exception("Could not delete property");
+}
+
+void object::delete_property(property_key const &key) {
+  if (is_null())
+    throw exception("Could not delete property (object is null)");
+  if (!delete_by_id(Impl::current_context(), get(), Impl::get_jsid(key)))
     throw exception("Could not delete property");
 }
 
@@ -279,7 +440,7 @@ bool object::is_null() const {
   return !get_const();
 }
 
-value object::apply(object const &fn, arguments const &arg_) {
+value object::apply(object const &fn, arguments const &arg) {
   if (is_null())
     throw exception("Could not apply function (object is null)");
 
@@ -289,8 +450,6 @@ value object::apply(object const &fn, arguments const &arg_) {
   value fnv(fn);
   root_value result((value()));
 
-  arguments arg(arg_);
-
   JSContext *cx = Impl::current_context();
 
   JSBool status = JS_CallFunctionValue(
@@ -298,7 +457,7 @@ value object::apply(object const &fn, arguments const &arg_) {
       get(),
       Impl::get_jsval(fnv),
       arg.size(),
-      Impl::get_arguments(arg),
+      argv(arg),
       Impl::get_jsvalp(result));
 
   if (!status) {
@@ -311,14 +470,12 @@ value object::apply(object const &fn, arguments const &arg_) {
   return result;
 }
 
-value object::call(char const *fn, arguments const &arg_) {
+value object::call(char const *fn, arguments const &arg) {
   if (is_null())
     throw exception("Could not call function (object is null)");
 
   root_value result((value()));
 
-  arguments arg(arg_);
-
   JSContext *cx = Impl::current_context();
 
   JSBool status = JS_CallFunctionName(
@@ -326,7 +483,7 @@ value object::call(char const *fn, arguments const &arg_) {
       get(),
       fn,
       arg.size(),
-      Impl::get_arguments(arg),
+      argv(arg),
       Impl::get_jsvalp(result));
 
   if (!status) {
@@ -0,0 +1,112 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/object_pool.hpp"
+#include <algorithm>
+
+using namespace flusspferd;
+using detail::object_pool;
+
+namespace {
+  // Registry of all pools, for object_pool_statistics.
+  boost::mutex registry_mutex;
+  object_pool *first_pool = 0;
+
+  std::size_t const slab_bytes = 16 * 1024;
+
+  std::size_t block_size(std::size_t size) {
+    std::size_t const align = alignof(std::max_align_t);
+    size = std::max(size, sizeof(void*));
+    return (size + align - 1) / align * align;
+  }
+}
+
+object_pool::object_pool(std::size_t size, char const *name)
+  : size(block_size(size)),
+    name(name),
+    free_list(0),
+    allocations(0),
+    frees(0),
+    next(0)
+{
+  boost::mutex::scoped_lock lock(registry_mutex);
+  next = first_pool;
+  first_pool = this;
+}
+
+void *object_pool::allocate() {
+  boost::mutex::scoped_lock lock(mutex);
+
+  if (!free_list) {
+    std::size_t n = std::max<std::size_t>(slab_bytes / size, 8);
+    char *slab = static_cast<char*>(::operator new(n * size));
+    slabs.push_back(slab);
+    for (std::size_t i = n; i > 0; --i) {
+      block *b = reinterpret_cast<block*>(slab + (i - 1) * size);
+      b->next = free_list;
+      free_list = b;
+    }
+  }
+
+  block *b = free_list;
+  free_list = b->next;
+  ++allocations;
+  return b;
+}
+
+void object_pool::free(void *p) {
+  if (!p)
+    return;
+
+  boost::mutex::scoped_lock lock(mutex);
+
+  block *b = static_cast<block*>(p);
+  b->next = free_list;
+  free_list = b;
+  ++frees;
+}
+
+object_pool_stats object_pool::stats() {
+  boost::mutex::scoped_lock lock(mutex);
+
+  object_pool_stats result;
+  result.class_name = name;
+  result.object_size = size;
+  result.allocations = allocations;
+  result.frees = frees;
+  result.slabs = slabs.size();
+  return result;
+}
+
+std::vector<object_pool_stats> flusspferd::object_pool_statistics() {
+  std::vector<object_pool_stats> result;
+
+  boost::mutex::scoped_lock lock(registry_mutex);
+  for (object_pool *p = first_pool; p; p = p->next_pool())
+    result.push_back(p->stats());
+  return result;
+}
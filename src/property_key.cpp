@@ -0,0 +1,120 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/property_key.hpp"
+#include "flusspferd/value.hpp"
+#include "flusspferd/string.hpp"
+#include "flusspferd/exception.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/value.hpp"
+#include "flusspferd/spidermonkey/string.hpp"
+#include <cmath>
+#include <js/jsapi.h>
+
+using namespace flusspferd;
+
+namespace {
+  Impl::property_key_impl index_key(JSContext *cx, jsint index) {
+    jsid id;
+    if (!JS_ValueToId(cx, INT_TO_JSVAL(index), &id))
+      throw exception("Could not create property key");
+    return Impl::wrap_jsid(id, true, index);
+  }
+
+  Impl::property_key_impl name_key(JSContext *cx, JSString *atom) {
+    jsid id;
+    if (!atom || !JS_ValueToId(cx, STRING_TO_JSVAL(atom), &id))
+      throw exception("Could not create property key");
+    return Impl::wrap_jsid(id, false, 0);
+  }
+
+  Impl::property_key_impl intern_key(JSContext *cx, JSString *str) {
+    if (!str)
+      throw exception("Could not create property key");
+    return name_key(
+      cx,
+      JS_InternUCStringN(cx, JS_GetStringChars(str), JS_GetStringLength(str)));
+  }
+
+  Impl::property_key_impl make_key(jsval v) {
+    JSContext *cx = Impl::current_context();
+
+    if (JSVAL_IS_INT(v))
+      return index_key(cx, JSVAL_TO_INT(v));
+
+    if (JSVAL_IS_DOUBLE(v)) {
+      double d = *JSVAL_TO_DOUBLE(v);
+      jsint i = jsint(d);
+      if (d == i && INT_FITS_IN_JSVAL(i) && !(i == 0 && std::signbit(d)))
+        return index_key(cx, i);
+    }
+
+    if (JSVAL_IS_STRING(v))
+      return intern_key(cx, JSVAL_TO_STRING(v));
+
+    return intern_key(cx, JS_ValueToString(cx, v));
+  }
+}
+
+property_key::property_key(char const *name)
+  : Impl::property_key_impl(
+      name_key(Impl::current_context(),
+               JS_InternString(Impl::current_context(), name)))
+{ }
+
+property_key::property_key(std::string const &name)
+  : Impl::property_key_impl(
+      name_key(Impl::current_context(),
+               JS_InternString(Impl::current_context(), name.c_str())))
+{ }
+
+property_key::property_key(string const &name)
+  : Impl::property_key_impl(
+      name_key(Impl::current_context(),
+               JS_InternUCStringN(Impl::current_context(),
+                                  (jschar*) name.data(), name.length())))
+{ }
+
+property_key::property_key(int index)
+  : Impl::property_key_impl(
+      INT_FITS_IN_JSVAL(index) ?
+        index_key(Impl::current_context(), index) :
+        name_key(Impl::current_context(),
+                 JS_InternString(Impl::current_context(),
+                                 std::to_string(index).c_str())))
+{ }
+
+property_key::property_key(value const &id)
+  : Impl::property_key_impl(make_key(Impl::get_jsval(id)))
+{ }
+
+value property_key::to_value() const {
+  jsval v;
+  if (!JS_IdToValue(Impl::current_context(), Impl::get_jsid(*this), &v))
+    throw exception("Could not convert property key to value");
+  return Impl::wrap_jsval(v);
+}
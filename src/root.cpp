@@ -32,7 +32,9 @@ THE SOFTWARE.
 #include "flusspferd/string.hpp"
 #include "flusspferd/function.hpp"
 #include "flusspferd/array.hpp"
+#include "flusspferd/tracer.hpp"
 #include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/root.hpp"
 #include "flusspferd/spidermonkey/context.hpp"
 #include "flusspferd/spidermonkey/value.hpp"
 #include <js/jsapi.h>
@@ -67,4 +69,103 @@ template class root<string>;
 template class root<function>;
 template class root<array>;
 
+template<typename T>
+arena_root<T>::arena_root(T const &o, root_arena &arena)
+: T(o), arena(arena), slot(arena.add(value(o)))
+{}
+
+template<typename T>
+arena_root<T>::~arena_root() {
+  arena.remove(slot);
+}
+
+template<typename T>
+void arena_root<T>::update() {
+  arena.set(slot, value(static_cast<T const &>(*this)));
+}
+
+template class arena_root<value>;
+template class arena_root<object>;
+template class arena_root<string>;
+template class arena_root<function>;
+template class arena_root<array>;
+
 }}
+
+using namespace flusspferd;
+
+void Impl::extra_roots::link() {
+  if (linked)
+    return;
+  prev = 0;
+  next = current_thread.roots;
+  if (next)
+    next->prev = this;
+  current_thread.roots = this;
+  linked = true;
+}
+
+void Impl::extra_roots::unlink() {
+  if (!linked)
+    return;
+  if (prev)
+    prev->next = next;
+  else
+    current_thread.roots = next;
+  if (next)
+    next->prev = prev;
+  prev = next = 0;
+  linked = false;
+}
+
+void Impl::extra_roots::trace_all(tracer &trc) {
+  for (extra_roots *p = current_thread.roots; p; p = p->next)
+    p->trace(trc);
+}
+
+root_arena::root_arena() {
+  link();
+}
+
+root_arena::~root_arena() {
+  unlink();
+}
+
+void root_arena::reserve(std::size_t n) {
+  slots.reserve(n);
+}
+
+root_arena::handle root_arena::add(value const &v) {
+  jsval x = Impl::get_jsval(v);
+  if (!free_slots.empty()) {
+    handle h = free_slots.back();
+    free_slots.pop_back();
+    slots[h] = x;
+    return h;
+  }
+  slots.push_back(x);
+  return slots.size() - 1;
+}
+
+void root_arena::remove(handle h) {
+  slots[h] = JSVAL_VOID;
+  free_slots.push_back(h);
+}
+
+value root_arena::get(handle h) const {
+  return Impl::wrap_jsval(slots[h]);
+}
+
+void root_arena::set(handle h, value const &v) {
+  slots[h] = Impl::get_jsval(v);
+}
+
+root_arena &root_arena::current() {
+  static thread_local root_arena arena;
+  return arena;
+}
+
+void root_arena::trace(tracer &trc) {
+  for (std::vector<jsval>::iterator it = slots.begin(); it != slots.end(); ++it)
+    trc.trace_gcptr("root_arena", &*it);
+}
@@ -31,7 +31,8 @@ THE SOFTWARE.
 #include "flusspferd/string_io.hpp"
 #include "flusspferd/create.hpp"
 #include "flusspferd/binary.hpp"
-#include <boost/scoped_array.hpp>
+#include "flusspferd/gc_allocator.hpp"
+#include <vector>
 #include <cstdlib>
 
 using namespace flusspferd;
@@ -53,8 +54,12 @@ std::streambuf *stream::streambuf() {
   return streambuf_;
 }
 
+// Text is read into gc_allocator buffers, so large reads count towards the
+// GC like the binary ones do.
+typedef std::vector<char, gc_allocator<char> > text_buffer;
+
 string stream::read_whole() {
-  std::string data;
+  text_buffer data;
   char buf[4096];
 
   std::streamsize length;
@@ -63,10 +68,10 @@ string stream::read_whole() {
     length = streambuf_->sgetn(buf, sizeof(buf));
     if (length < 0)
       length = 0;
-    data.append(buf, length);
+    data.insert(data.end(), buf, buf + length);
   } while (length > 0);
 
-  return string(data);
+  return string(std::string_view(data.data(), data.size()));
 }
 
 object stream::read_whole_binary(boost::optional<byte_array&> output_) {
@@ -96,20 +101,20 @@ object stream::read_whole_binary(boost::optional<byte_array&> output_) {
     data.resize(data.size() - N + length);
   } while (length > 0);
 
+  output.update_external_size();
   return output;
 }
 
 string stream::read(boost::optional<unsigned> size_opt) {
   unsigned size = size_opt.get_value_or(4096);
   
-  boost::scoped_array<char> buf(new char[size + 1]);
+  text_buffer buf(size);
 
-  std::streamsize length = streambuf_->sgetn(buf.get(), size);
+  std::streamsize length = streambuf_->sgetn(buf.data(), size);
   if (length < 0)
     length = 0;
-  buf[length] = '\0';
 
-  return string(buf.get());
+  return string(std::string_view(buf.data(), length));
 }
 
 object stream::read_binary(boost::optional<unsigned> size_opt, boost::optional<byte_array&> output_)
@@ -138,6 +143,7 @@ object stream::read_binary(boost::optional<unsigned> size_opt, boost::optional<b
 
   data.resize(data.size() - size + length);
 
+  output.update_external_size();
   return output;
 }
 
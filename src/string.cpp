@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "flusspferd/spidermonkey/value.hpp"
 #include "flusspferd/spidermonkey/context.hpp"
 #include <js/jsapi.h>
+#include <algorithm>
 #include <cstring>
 #include <string>
 
@@ -82,8 +83,12 @@ string::string(flusspferd::js_char16_t const *s, std::size_t n)
   : Impl::string_impl(s, n) { }
 string::string(std::string const &s)
   : Impl::string_impl(s.data(), s.size()) { }
+string::string(std::string_view s)
+  : Impl::string_impl(s.data(), s.size()) { }
 string::string(std::basic_string<flusspferd::js_char16_t> const &s)
   : Impl::string_impl(s.data(), s.size()) { }
+string::string(std::basic_string_view<flusspferd::js_char16_t> s)
+  : Impl::string_impl(s.data(), s.size()) { }
 string::~string() { }
 
 string &string::operator=(string const &o) {
@@ -106,6 +111,55 @@ char const *string::c_str() const {
   return JS_GetStringBytes(get_string(*this));
 }
 
+// The engine's UTF-8 copy is NUL-terminated, so it cannot hold U+0000, and
+// for a string it cannot encode the engine returns "". Its length is only
+// ever taken from the copy itself.
+std::string_view string::utf8_view(std::string &storage) const {
+  JSString *str = get_string(*this);
+  assert(str);
+  jschar const *chars = JS_GetStringChars(str);
+  std::size_t len = JS_GetStringLength(str);
+
+  if (std::find(chars, chars + len, jschar(0)) == chars + len) {
+    char const *bytes = JS_GetStringBytes(str);
+    if (len == 0 || *bytes)
+      return std::string_view(bytes, std::strlen(bytes));
+  }
+
+  storage.clear();
+  storage.reserve(len);
+  for (std::size_t i = 0; i < len; ++i) {
+    unsigned long c = chars[i];
+    if (c >= 0xD800 && c < 0xE000) {
+      if (c < 0xDC00 && i + 1 < len &&
+          chars[i + 1] >= 0xDC00 && chars[i + 1] < 0xE000)
+      {
+        c = 0x10000 + ((c - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+        ++i;
+      } else {
+        c = 0xFFFD;
+      }
+    }
+
+    if (c < 0x80) {
+      storage += char(c);
+    } else if (c < 0x800) {
+      storage += char(0xC0 | (c >> 6));
+      storage += char(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+      storage += char(0xE0 | (c >> 12));
+      storage += char(0x80 | ((c >> 6) & 0x3F));
+      storage += char(0x80 | (c & 0x3F));
+    } else {
+      storage += char(0xF0 | (c >> 18));
+      storage += char(0x80 | ((c >> 12) & 0x3F));
+      storage += char(0x80 | ((c >> 6) & 0x3F));
+      storage += char(0x80 | (c & 0x3F));
+    }
+  }
+  return storage;
+}
+
 std::string string::to_string() const {
   assert(get_string(*this));
   return JS_GetStringBytes(get_string(*this));
@@ -0,0 +1,95 @@
+// vim:ts=2:sw=2:expandtab:autoindent:filetype=cpp:
+/*
+The MIT License
+
+Copyright (c) 2008, 2009 Flusspferd contributors (see "CONTRIBUTORS" or
+                                       http://flusspferd.org/contributors.txt)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "flusspferd/struct_description.hpp"
+#include "flusspferd/exception.hpp"
+#include "flusspferd/local_root_scope.hpp"
+#include "flusspferd/spidermonkey/init.hpp"
+#include "flusspferd/spidermonkey/object.hpp"
+#include <js/jsapi.h>
+
+using namespace flusspferd;
+
+namespace {
+  // Private: the viewed struct (not owned). Reserved slot 0: the spec table
+  // of the struct type, identifying it.
+  JSClass struct_view_class = {
+    "StructView",
+    JSCLASS_HAS_PRIVATE | JSCLASS_HAS_RESERVED_SLOTS(1),
+    JS_PropertyStub, JS_PropertyStub, JS_PropertyStub, JS_PropertyStub,
+    JS_EnumerateStub, JS_ResolveStub, JS_ConvertStub, JS_FinalizeStub,
+    JSCLASS_NO_OPTIONAL_MEMBERS
+  };
+}
+
+object Impl::create_struct_view(void *ptr, property_spec *specs) {
+  JSContext *ctx = Impl::current_context();
+
+  local_root_scope scope;
+
+  JSObject *obj = JS_NewObject(ctx, &struct_view_class, 0, 0);
+  if (!obj)
+    throw exception("Could not create struct view");
+
+  if (!JS_SetReservedSlot(ctx, obj, 0, PRIVATE_TO_JSVAL(specs)))
+    throw exception("Could not create struct view");
+
+  JS_SetPrivate(ctx, obj, ptr);
+
+  if (!JS_DefineProperties(ctx, obj, specs))
+    throw exception("Could not create struct view");
+
+  return Impl::wrap_object(obj);
+}
+
+void *Impl::get_struct_view(object const &view, property_spec *specs) {
+  JSContext *ctx = Impl::current_context();
+  JSObject *obj = Impl::get_object(view);
+
+  if (!obj || !JS_InstanceOf(ctx, obj, &struct_view_class, 0))
+    throw exception("Object is no struct view");
+
+  jsval tag;
+  if (!JS_GetReservedSlot(ctx, obj, 0, &tag) || JSVAL_TO_PRIVATE(tag) != specs)
+    throw exception("Struct view is of a different type");
+
+  void *ptr = JS_GetPrivate(ctx, obj);
+  if (!ptr)
+    throw exception("Struct view is detached");
+
+  return ptr;
+}
+
+void flusspferd::detach_struct_view(object const &view) {
+  JSContext *ctx = Impl::current_context();
+  JSObject *obj = Impl::get_object(view);
+
+  if (!obj || !JS_InstanceOf(ctx, obj, &struct_view_class, 0))
+    throw exception("Object is no struct view");
+
+  JS_SetPrivate(ctx, obj, 0);
+}
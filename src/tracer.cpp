@@ -32,27 +32,14 @@ THE SOFTWARE.
 
 using namespace flusspferd;
 
-class tracer::impl {
-public:
-  impl(void *x)
+tracer::tracer(void *x)
+  : opaque(x),
 #if JS_VERSION >= 180
-  : trc((JSTracer*) x)
+    cx(0)
 #else
-  : cx(Impl::current_context()), x(x)
+    cx(Impl::current_context())
 #endif
-  {}
-
-#if JS_VERSION >= 180
-  JSTracer *trc;
-#else
-  JSContext *cx;
-  void *x;
-#endif
-};
-
-tracer::tracer(void *x) : p(new impl(x)) { }
-
-tracer::~tracer() {}
+{ }
 
 void tracer::trace_gcptr(char const *name, void *gcthing) {
   if (!gcthing)
@@ -61,10 +48,10 @@ void tracer::trace_gcptr(char const *name, void *gcthing) {
   jsval v = * (jsval *) gcthing;
 
 #if JS_VERSION >= 180
-  JS_CALL_VALUE_TRACER(p->trc, v, name);
+  JS_CALL_VALUE_TRACER((JSTracer *) opaque, v, name);
 #else
   if (!JSVAL_IS_GCTHING(v))
     return;
-  JS_MarkGCThing(p->cx, JSVAL_TO_GCTHING(v), name, p->x);
+  JS_MarkGCThing((JSContext *) cx, JSVAL_TO_GCTHING(v), name, opaque);
 #endif
 }
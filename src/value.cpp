@@ -88,14 +88,36 @@ std::string value::to_std_string() const {
 }
 
 double value::to_number() const {
+  jsval v = get();
+  if (JSVAL_IS_INT(v))
+    return JSVAL_TO_INT(v);
+  if (JSVAL_IS_DOUBLE(v))
+    return *JSVAL_TO_DOUBLE(v);
   double value;
-  if (!JS_ValueToNumber(Impl::current_context(), get(), &value))
+  if (!JS_ValueToNumber(Impl::current_context(), v, &value))
     throw exception("Could not convert value to number");
   return value;
 }
 
 double value::to_integral_number(int bits, bool signedness) const {
-  long double value = to_number();
+  jsval v = get();
+
+  // Tagged ints are wrapped with plain integer arithmetic.
+  if (JSVAL_IS_INT(v)) {
+    boost::int64_t num = JSVAL_TO_INT(v);
+    if (bits >= 64) {
+      if (num < 0 && !signedness)
+        return double(num) + 18446744073709551616.0; // 2^64
+      return double(num);
+    }
+    boost::uint64_t const modulus = boost::uint64_t(1) << bits;
+    boost::uint64_t wrapped = boost::uint64_t(num) & (modulus - 1);
+    if (signedness && wrapped >= modulus / 2)
+      return double(boost::int64_t(wrapped - modulus));
+    return double(wrapped);
+  }
+
+  double value = to_number();
 #ifdef _MSC_VER
   if (!_finite(value))
     return 0;
@@ -103,19 +125,41 @@ double value::to_integral_number(int bits, bool signedness) const {
   if (!std::isfinite(value))
     return 0;
 #endif
-  long double maxU = powl(2, bits);
-  value = value < 0 ? ceill(value) : floorl(value);
-  value = fmodl(value, maxU);
+  // trunc and fmod are exact on doubles, no need for long double here.
+  double const modulus = std::ldexp(1.0, bits);
+  value = std::fmod(std::trunc(value), modulus);
   if (value < 0)
-    value += maxU;
-  if (signedness) {
-    long double maxS = maxU / 2;
-    if (value > maxS)
-      value -= maxU;
-  }
+    value += modulus;
+  if (signedness && value >= modulus / 2)
+    value -= modulus;
   return value;
 }
 
+boost::int32_t value::to_int32() const {
+  jsval v = get();
+  if (JSVAL_IS_INT(v))
+    return JSVAL_TO_INT(v);
+  return boost::int32_t(to_uint32());
+}
+
+boost::uint32_t value::to_uint32() const {
+  jsval v = get();
+  if (JSVAL_IS_INT(v))
+    return boost::uint32_t(JSVAL_TO_INT(v));
+  double value = to_number();
+#ifdef _MSC_VER
+  if (!_finite(value))
+    return 0;
+#else
+  if (!std::isfinite(value))
+    return 0;
+#endif
+  value = std::fmod(std::trunc(value), 4294967296.0); // 2^32
+  if (value < 0)
+    value += 4294967296.0;
+  return boost::uint32_t(value);
+}
+
 bool value::to_boolean() const {
   JSBool result;
   if (!JS_ValueToBoolean(Impl::current_context(), get(), &result))
@@ -155,6 +199,14 @@ void value::unbind() {
 }
 
 Impl::value_impl Impl::value_impl::from_double(double num) {
+  // Integral values that fit are stored as tagged ints, without boxing a
+  // double on the GC heap. -0 has to stay a double.
+  if (num >= jsint(JSVAL_INT_MIN) && num <= jsint(JSVAL_INT_MAX)) {
+    jsint i = jsint(num);
+    if (jsdouble(i) == num && (i != 0 || !std::signbit(num)))
+      return wrap_jsval(INT_TO_JSVAL(i));
+  }
+
   value_impl result;
   if (!JS_NewNumberValue(
         Impl::current_context(), jsdouble(num), result.getp()))